@@ -0,0 +1,434 @@
+/* A reader for AEDAT4 files -- the event-camera recordings that DV writes -- so that
+   bin/ebc_to_frames can read a recording directly, rather than through
+   scripts/aedat_to_csv.py and a text file with a line per event.
+
+   An AEDAT4 file is:
+
+   - "#!AER-DAT4.0\r\n".
+   - An int32 size, and then an IOHeader flatbuffer of that size.  It holds the compression
+     (NONE, LZ4, LZ4_HIGH, ZSTD or ZSTD_HIGH), the file position of the data table at the end
+     of the file (or -1), and an XML description of the streams, which says which stream ids
+     carry events (their typeIdentifier is "EVTS").
+   - Packets: an int32 stream id, an int32 size, and then that many bytes of a compressed
+     flatbuffer.  An event packet's flatbuffer has the identifier "EVTS", and its one field is
+     a vector of 16-byte events: int64 t (microseconds), int16 x, int16 y and bool on.
+   - The data table, which is an index of the packets.  We don't need it.
+
+   Everything is little-endian, like the machines we run on.  Next_Packet() reads and
+   decompresses one packet at a time, so the reader never holds more than one packet, and
+   packets from other streams (frames, IMU, triggers) are skipped without being decompressed.
+
+   LZ4 (the frame format, which is what DV writes) is decoded here.  ZSTD comes from libzstd,
+   which is loaded with dlopen() the first time a ZSTD packet shows up, so it isn't a build
+   dependency.  If it can't be loaded, ZSTD recordings are an error.  Errors are fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <dlfcn.h>
+#include <sys/stat.h>
+
+#define AEDAT4_MAGIC "#!AER-DAT4.0\r\n"
+
+struct AEDAT4_Event {
+  int64_t T;                           /* Microseconds */
+  int16_t X, Y;
+  bool On;
+};
+
+class AEDAT4_Reader {
+  public:
+    ~AEDAT4_Reader() { if (F != NULL) fclose(F); }
+
+    void Open(const std::string &filename);
+    bool Next_Packet(std::vector <AEDAT4_Event> &events);   /* Replaces events.  False at the end. */
+
+    int Compression = 0;                 /* 0-4: NONE, LZ4, LZ4_HIGH, ZSTD, ZSTD_HIGH */
+
+  protected:
+    FILE *F = NULL;
+    std::string Filename;
+    int64_t Pos = 0;                     /* The file position */
+    int64_t Data_Table = -1;             /* Where the packets end, or -1 for the end of the file */
+    std::vector <int> Event_Streams;     /* From the XML.  If it's empty, we look at every packet. */
+    std::vector <unsigned char> Raw;     /* The packet, as it is in the file */
+    std::vector <unsigned char> Data;    /* The packet, decompressed */
+
+    void Fatal(const char *what) const __attribute__ ((noreturn));
+    bool Read(void *buf, size_t n);      /* False at the end of the file.  Fatal if it's short. */
+    void Decompress();
+    void Find_Event_Streams(const std::string &xml);
+};
+
+/* Is this an AEDAT4 file?  Only regular files are checked, so that reading the magic number
+   doesn't eat the start of a pipe. */
+
+inline bool AEDAT4_Is_File(const std::string &filename)
+{
+  FILE *f;
+  char buf[sizeof(AEDAT4_MAGIC)];
+  size_t n;
+  struct stat st;
+
+  if (stat(filename.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+  f = fopen(filename.c_str(), "rb");
+  if (f == NULL) return false;
+  n = fread(buf, 1, strlen(AEDAT4_MAGIC), f);
+  fclose(f);
+  return (n == strlen(AEDAT4_MAGIC) && memcmp(buf, AEDAT4_MAGIC, n) == 0);
+}
+
+/* ------------------------------------------------------------ */
+/* Flatbuffers, by hand.  A table starts with an int32 offset back to its vtable, which is a
+   uint16 vtable size, a uint16 table size, and then the uint16 offset of each field in the
+   table (0 if the field isn't there).  Strings and vectors are a uint32 offset from the
+   field to a uint32 length, followed by the elements.  These return 0 for anything that
+   isn't there or doesn't fit. */
+
+inline size_t AEDAT4_Table_Field(const std::vector <unsigned char> &b, size_t table, int field)
+{
+  int32_t soff;
+  int64_t vt;
+  uint16_t vsize, off;
+
+  if (table < 4 || table + 4 > b.size()) return 0;
+  memcpy(&soff, &b[table], 4);
+  vt = (int64_t) table - soff;
+  if (vt < 0 || (size_t) vt + 4 > b.size()) return 0;
+  memcpy(&vsize, &b[vt], 2);
+  if (4 + 2 * field + 2 > vsize || (size_t) vt + 4 + 2 * field + 2 > b.size()) return 0;
+  memcpy(&off, &b[vt + 4 + 2 * field], 2);
+  if (off == 0 || table + off >= b.size()) return 0;
+  return table + off;
+}
+
+/* The root table, whose offset is at the start of the buffer. */
+
+inline size_t AEDAT4_Root(const std::vector <unsigned char> &b)
+{
+  uint32_t off;
+
+  if (b.size() < 8) return 0;
+  memcpy(&off, &b[0], 4);
+  return (off < b.size()) ? off : 0;
+}
+
+/* Follow the offset at p to a string or vector, and return where its length is. */
+
+inline size_t AEDAT4_Follow(const std::vector <unsigned char> &b, size_t p)
+{
+  uint32_t off;
+
+  if (p == 0 || p + 4 > b.size()) return 0;
+  memcpy(&off, &b[p], 4);
+  if ((uint64_t) p + off + 4 > b.size()) return 0;
+  return p + off;
+}
+
+/* ------------------------------------------------------------ */
+/* LZ4.  A frame is a magic number, a descriptor, and then blocks, each of which is a uint32
+   size (high bit set if the block isn't compressed) followed by the block, and maybe a
+   checksum.  A block is a series of sequences: a token, whose high nibble is the number of
+   literals, the literals, a 2-byte offset back into the output, and a match of (low nibble
+   + 4) bytes from there.  Lengths of 15 continue in the next bytes.  We decode into one
+   contiguous buffer, so blocks that refer back into earlier blocks just work. */
+
+inline bool AEDAT4_LZ4_Block(const unsigned char *src, size_t n, std::vector <unsigned char> &out,
+                             size_t max)
+{
+  size_t i, len, off, o, k;
+  unsigned char token, b;
+  unsigned char *d;
+
+  /* Decode into room for the biggest block, through a pointer, and then trim.  Going through
+     the vector a sequence at a time is slow. */
+
+  o = out.size();
+  out.resize(o + max);
+  d = out.data();
+  i = 0;
+  while (i < n) {
+    token = src[i++];
+    len = token >> 4;
+    if (len == 15) {
+      do { if (i >= n) return false; b = src[i++]; len += b; } while (b == 255);
+    }
+    if (len > n - i || len > out.size() - o) return false;
+    memcpy(d + o, src + i, len);
+    o += len;
+    i += len;
+    if (i == n) break;                        /* The last sequence is just literals */
+
+    if (i + 2 > n) return false;
+    off = src[i] | (src[i+1] << 8);
+    i += 2;
+    if (off == 0 || off > o) return false;
+    len = token & 15;
+    if (len == 15) {
+      do { if (i >= n) return false; b = src[i++]; len += b; } while (b == 255);
+    }
+    len += 4;
+    if (len > out.size() - o) return false;
+    if (off >= len) {
+      memcpy(d + o, d + o - off, len);
+    } else {
+      for (k = 0; k < len; k++) d[o + k] = d[o + k - off];  /* Byte by byte, since they overlap */
+    }
+    o += len;
+  }
+  out.resize(o);
+  return true;
+}
+
+inline bool AEDAT4_LZ4_Frames(const std::vector <unsigned char> &src, std::vector <unsigned char> &out)
+{
+  size_t p, n, max;
+  uint32_t magic, size;
+  unsigned char flg, bd;
+
+  out.clear();
+  n = src.size();
+  p = 0;
+  while (p + 4 <= n) {
+    memcpy(&magic, &src[p], 4);
+    if ((magic & 0xfffffff0) == 0x184d2a50) {          /* A skippable frame */
+      if (p + 8 > n) return false;
+      memcpy(&size, &src[p+4], 4);
+      p += 8 + (size_t) size;
+      continue;
+    }
+    if (magic != 0x184d2204 || p + 7 > n) return false;
+    flg = src[p+4];
+    if ((flg >> 6) != 1 || (flg & 1)) return false;    /* Version 1, and no dictionary */
+    bd = (src[p+5] >> 4) & 7;
+    if (bd < 4) return false;
+    max = (size_t) 1 << (2 * bd + 8);                  /* 64K, 256K, 1M or 4M */
+    p += 6 + ((flg & 8) ? 8 : 0) + 1;                  /* Descriptor, content size, checksum */
+    while (true) {
+      if (p + 4 > n) return false;
+      memcpy(&size, &src[p], 4);
+      p += 4;
+      if (size == 0) break;
+      if ((size & 0x7fffffff) > n - p) return false;
+      if (size & 0x80000000) {
+        size &= 0x7fffffff;
+        out.insert(out.end(), src.begin() + p, src.begin() + p + size);
+      } else if (!AEDAT4_LZ4_Block(&src[p], size, out, max)) {
+        return false;
+      }
+      p += size + ((flg & 0x10) ? 4 : 0);              /* Block checksum */
+    }
+    p += (flg & 4) ? 4 : 0;                            /* Content checksum */
+  }
+  return (p == n);
+}
+
+/* ------------------------------------------------------------ */
+/* ZSTD, from libzstd, if we can find it. */
+
+struct AEDAT4_ZSTD {
+  bool Tried = false;
+  size_t (*Decompress)(void *dst, size_t cap, const void *src, size_t n) = NULL;
+  unsigned long long (*Content_Size)(const void *src, size_t n) = NULL;
+  unsigned (*Is_Error)(size_t code) = NULL;
+};
+
+inline AEDAT4_ZSTD &AEDAT4_Load_ZSTD()
+{
+  static AEDAT4_ZSTD z;
+  const char *names[] = { "libzstd.so.1", "libzstd.so", "libzstd.1.dylib", "libzstd.dylib",
+                          "/opt/homebrew/lib/libzstd.dylib", "/usr/local/lib/libzstd.dylib", NULL };
+  void *h;
+  int i;
+
+  if (z.Tried) return z;
+  z.Tried = true;
+  h = NULL;
+  for (i = 0; h == NULL && names[i] != NULL; i++) h = dlopen(names[i], RTLD_NOW);
+  if (h == NULL) return z;
+  z.Decompress = (size_t (*)(void *, size_t, const void *, size_t)) dlsym(h, "ZSTD_decompress");
+  z.Content_Size = (unsigned long long (*)(const void *, size_t)) dlsym(h, "ZSTD_getFrameContentSize");
+  z.Is_Error = (unsigned (*)(size_t)) dlsym(h, "ZSTD_isError");
+  if (z.Decompress == NULL || z.Content_Size == NULL || z.Is_Error == NULL) z.Decompress = NULL;
+  return z;
+}
+
+/* If the frame doesn't say how big it is, keep doubling the buffer until it fits. */
+
+inline bool AEDAT4_ZSTD_Frames(const std::vector <unsigned char> &src, std::vector <unsigned char> &out)
+{
+  AEDAT4_ZSTD &z = AEDAT4_Load_ZSTD();
+  unsigned long long size;
+  size_t cap, rv;
+
+  if (z.Decompress == NULL) {
+    fprintf(stderr, "AEDAT4: this recording is compressed with ZSTD, and libzstd can't be loaded.\n");
+    exit(1);
+  }
+  size = z.Content_Size(src.data(), src.size());
+  if (size == 0ULL - 2) return false;
+  cap = (size != 0ULL - 1) ? (size_t) size : src.size() * 4 + 4096;
+  while (true) {
+    out.resize(cap);
+    rv = z.Decompress(out.data(), cap, src.data(), src.size());
+    if (!z.Is_Error(rv)) {
+      out.resize(rv);
+      return true;
+    }
+    if (size != 0ULL - 1 || cap >= ((size_t) 1 << 32)) return false;
+    cap *= 2;
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+inline void AEDAT4_Reader::Fatal(const char *what) const
+{
+  fprintf(stderr, "%s: AEDAT4: %s\n", Filename.c_str(), what);
+  exit(1);
+}
+
+inline bool AEDAT4_Reader::Read(void *buf, size_t n)
+{
+  size_t got;
+
+  got = fread(buf, 1, n, F);
+  if (got == 0 && n > 0 && feof(F)) return false;
+  if (got != n) Fatal("the file ends in the middle of something");
+  Pos += n;
+  return true;
+}
+
+/* The XML has a <node name="N"> for each stream, with <attr key="typeIdentifier">EVTS</attr>
+   in it when the stream is events. */
+
+inline void AEDAT4_Reader::Find_Event_Streams(const std::string &xml)
+{
+  size_t p, q;
+  int stream;
+  char *end;
+  std::string name;
+
+  stream = -1;
+  p = 0;
+  while (true) {
+    q = xml.find("<node name=\"", p);
+    p = xml.find("typeIdentifier", p);
+    if (p == std::string::npos && q == std::string::npos) break;
+    if (q < p) {                                  /* A node: remember it if it's a number */
+      q += strlen("<node name=\"");
+      name = xml.substr(q, xml.find('"', q) - q);
+      stream = strtol(name.c_str(), &end, 10);
+      if (name == "" || *end != '\0') stream = -1;
+      p = q;
+    } else {                                      /* A type: is it events? */
+      p = xml.find('>', p);
+      if (p == std::string::npos) break;
+      if (xml.compare(p + 1, 4, "EVTS") == 0 && stream >= 0) Event_Streams.push_back(stream);
+    }
+  }
+}
+
+inline void AEDAT4_Reader::Open(const std::string &filename)
+{
+  char magic[sizeof(AEDAT4_MAGIC)];
+  int32_t size;
+  size_t f, s;
+  uint32_t len;
+  int32_t compression;
+  std::string xml;
+
+  Filename = filename;
+  F = fopen(filename.c_str(), "rb");
+  if (F == NULL) { perror(filename.c_str()); exit(1); }
+  if (!Read(magic, strlen(AEDAT4_MAGIC)) || memcmp(magic, AEDAT4_MAGIC, strlen(AEDAT4_MAGIC)) != 0) {
+    Fatal("not an AEDAT4 file");
+  }
+
+  if (!Read(&size, 4) || size < 8) Fatal("bad header size");
+  Raw.resize(size);
+  if (!Read(Raw.data(), size)) Fatal("no header");
+
+  /* The IOHeader's fields: compression, dataTablePosition, infoNode. */
+
+  f = AEDAT4_Root(Raw);
+  if (f == 0) Fatal("bad header");
+  if ((s = AEDAT4_Table_Field(Raw, f, 0)) != 0 && s + 4 <= Raw.size()) {
+    memcpy(&compression, &Raw[s], 4);
+    Compression = compression;
+  }
+  if (Compression < 0 || Compression > 4) Fatal("unknown compression");
+  if ((s = AEDAT4_Table_Field(Raw, f, 1)) != 0 && s + 8 <= Raw.size()) memcpy(&Data_Table, &Raw[s], 8);
+  if ((s = AEDAT4_Follow(Raw, AEDAT4_Table_Field(Raw, f, 2))) != 0) {
+    memcpy(&len, &Raw[s], 4);
+    if (s + 4 + (size_t) len <= Raw.size()) xml.assign((const char *) &Raw[s + 4], len);
+  }
+  Find_Event_Streams(xml);
+}
+
+inline void AEDAT4_Reader::Decompress()
+{
+  bool ok;
+
+  if (Compression == 0) {
+    Data.swap(Raw);
+    return;
+  }
+  ok = (Compression <= 2) ? AEDAT4_LZ4_Frames(Raw, Data) : AEDAT4_ZSTD_Frames(Raw, Data);
+  if (!ok) Fatal((Compression <= 2) ? "bad LZ4 data" : "bad ZSTD data");
+}
+
+inline bool AEDAT4_Reader::Next_Packet(std::vector <AEDAT4_Event> &events)
+{
+  int32_t header[2];
+  size_t i, v, e;
+  uint32_t n;
+  bool wanted;
+  int16_t xy[2];
+  AEDAT4_Event ev;
+
+  events.clear();
+  while (Data_Table < 0 || Pos < Data_Table) {
+    if (!Read(header, 8)) return false;
+    if (header[1] < 0) Fatal("bad packet size");
+
+    wanted = Event_Streams.empty();
+    for (i = 0; i < Event_Streams.size(); i++) if (Event_Streams[i] == header[0]) wanted = true;
+    if (!wanted) {
+      if (fseeko(F, header[1], SEEK_CUR) != 0) Fatal("can't skip a packet");
+      Pos += header[1];
+      continue;
+    }
+
+    Raw.resize(header[1]);
+    if (!Read(Raw.data(), header[1])) Fatal("the file ends in the middle of a packet");
+    Decompress();
+    if (Data.size() < 8 || memcmp(&Data[4], "EVTS", 4) != 0) continue;
+
+    /* EventPacket's one field is the vector of events. */
+
+    v = AEDAT4_Follow(Data, AEDAT4_Table_Field(Data, AEDAT4_Root(Data), 0));
+    if (v == 0) continue;
+    memcpy(&n, &Data[v], 4);
+    if (v + 4 + (size_t) n * 16 > Data.size()) Fatal("bad event packet");
+    events.resize(n);
+    for (i = 0; i < n; i++) {
+      e = v + 4 + i * 16;
+      memcpy(&ev.T, &Data[e], 8);
+      memcpy(xy, &Data[e + 8], 4);
+      ev.X = xy[0];
+      ev.Y = xy[1];
+      ev.On = (Data[e + 12] != 0);
+      events[i] = ev;
+    }
+    return true;
+  }
+  return false;
+}
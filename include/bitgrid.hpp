@@ -0,0 +1,481 @@
+/* Bit-packed grids of events for the CPU implementations of DBSCAN and 3D DBSCAN.
+
+   A BitGrid stores one bit per cell, 64 columns to a uint64_t word.  Column c of a row is
+   bit (c % 64) of word (c / 64).  Bits past the last column are always zero.
+
+   A BitCount stores a small integer per cell in "bit-sliced" form: plane b of a row holds
+   bit b of the counts of all of the columns of that row.  That way, adding a row of events
+   to the counts is a ripple-carry over the planes, which handles 64 columns with each
+   and/xor, rather than one column per add.
+
+   The neighborhood counts are built as follows:
+
+   - Box_Count() shifts each row by -e..e columns, and adds the shifted rows into a BitCount.
+     That gives you the horizontal count of each cell.  Then it keeps a running sum of
+     2e+1 of those rows to get the (2e+1)x(2e+1) box count of each cell.
+   - At_Least() compares each count to a constant, setting the bits of the cells whose count
+     is >= the constant.
+   - Box_Dilate() is the same thing as Box_Count(), but with OR instead of add, so a bit is
+     set if any bit in its box is set.
+
+   The kernels need some temporary rows and grids.  If you give them a BitScratch, they keep
+   those in it, so once it has grown to the size of your frames, the kernels never allocate.
+   That's what the engines in src/libdbscan.cpp do, so pushing a frame doesn't allocate.
+
+   All of the work is done by loops over the words of a row, so if you compile with
+   CFLAGS='-O3 -march=native', the compiler turns them into AVX2 or AVX-512 instructions.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class BitGrid {
+  public:
+    int Rows = 0;
+    int Cols = 0;
+    int Words = 0;                             /* Words per row: (Cols+63)/64 */
+    std::vector <uint64_t> Bits;
+
+    void     Resize(int rows, int cols);       /* Set the size, and clear all of the bits */
+    void     Clear();                          /* Clear all of the bits */
+    int      Add_Row(const std::string &s);    /* Append a row of '0'/'1' characters.  Characters
+                                                  past Cols are ignored, and missing characters
+                                                  are zero.  Returns the column of the first
+                                                  character that isn't '0' or '1', or -1. */
+    bool     Get(int r, int c) const;
+    void     Set(int r, int c);
+    uint64_t *Row(int r);
+    const uint64_t *Row(int r) const;
+    uint64_t Tail_Mask() const;                /* Mask of the valid bits in the last word of a row */
+    long long Count() const;                   /* Number of set bits (popcount) */
+};
+
+class BitCount {
+  public:
+    int Rows = 0;
+    int Cols = 0;
+    int Words = 0;
+    int Planes = 0;                            /* Counts go up to 2^Planes - 1 */
+    std::vector <uint64_t> Bits;               /* Row r, plane b is at Bits[(r*Planes+b)*Words] */
+
+    void     Resize(int rows, int cols, int planes);
+    void     Clear();
+    uint64_t *Plane(int r, int b);
+    const uint64_t *Plane(int r, int b) const;
+    int      Get(int r, int c) const;          /* The count of one cell -- for debugging. */
+};
+
+/* Temporary memory for the kernels, which they resize as needed and reuse. */
+
+class BitScratch {
+  public:
+    BitCount Counts;
+    BitGrid Grid;
+    std::vector <uint64_t> Row1, Row2, Planes;
+};
+
+/* The number of planes that you need to hold counts up to max_count. */
+
+int  Bit_Planes_For(int max_count);
+
+/* dst[c] = src[c+d], and zero if c+d is off the row.  This works for any d. */
+
+void Shift_Row(const uint64_t *src, uint64_t *dst, int words, uint64_t tail_mask, int d);
+
+/* out[r][c] = the number of set bits of g in rows r-e..r+e and columns c-e..c+e.  Out must
+   already be sized to g, with enough planes. */
+
+void Box_Count(const BitGrid &g, int e, BitCount &out);
+void Box_Count(const BitGrid &g, int e, BitCount &out, BitScratch &s);
+
+/* acc += x or acc -= x, cell by cell.  They must be the same size.  Acc must not overflow
+   or underflow. */
+
+void Add_Counts(BitCount &acc, const BitCount &x);
+void Add_Counts(BitCount &acc, const BitCount &x, BitScratch &s);
+void Subtract_Counts(BitCount &acc, const BitCount &x);
+void Subtract_Counts(BitCount &acc, const BitCount &x, BitScratch &s);
+
+/* out[r][c] = (cnt[r][c] >= v) */
+
+void At_Least(const BitCount &cnt, int v, BitGrid &out);
+void At_Least(const BitCount &cnt, int v, BitGrid &out, BitScratch &s);
+
+/* out[r][c] = OR of g in rows r-e..r+e and columns c-e..c+e */
+
+void Box_Dilate(const BitGrid &g, int e, BitGrid &out);
+void Box_Dilate(const BitGrid &g, int e, BitGrid &out, BitScratch &s);
+
+/* ------------------------------------------------------------ */
+/* BitGrid */
+
+inline void BitGrid::Resize(int rows, int cols)
+{
+  Rows = rows;
+  Cols = cols;
+  Words = (cols + 63) / 64;
+  Bits.assign((size_t) Rows * Words, 0);
+}
+
+inline void BitGrid::Clear()
+{
+  Bits.assign(Bits.size(), 0);
+}
+
+inline int BitGrid::Add_Row(const std::string &s)
+{
+  int c, n;
+  uint64_t *row;
+
+  Rows++;
+  Bits.resize((size_t) Rows * Words, 0);
+  row = Row(Rows-1);
+  n = ((int) s.size() < Cols) ? s.size() : Cols;
+  for (c = 0; c < (int) s.size(); c++) {
+    if (s[c] != '0' && s[c] != '1') return c;
+    if (c < n && s[c] == '1') row[c >> 6] |= (1ULL << (c & 63));
+  }
+  return -1;
+}
+
+inline bool BitGrid::Get(int r, int c) const
+{
+  return (Bits[(size_t) r * Words + (c >> 6)] >> (c & 63)) & 1;
+}
+
+inline void BitGrid::Set(int r, int c)
+{
+  Bits[(size_t) r * Words + (c >> 6)] |= (1ULL << (c & 63));
+}
+
+inline uint64_t *BitGrid::Row(int r)
+{
+  return Bits.data() + (size_t) r * Words;
+}
+
+inline const uint64_t *BitGrid::Row(int r) const
+{
+  return Bits.data() + (size_t) r * Words;
+}
+
+inline uint64_t BitGrid::Tail_Mask() const
+{
+  return (Cols % 64 == 0) ? ~0ULL : ((1ULL << (Cols % 64)) - 1);
+}
+
+inline long long BitGrid::Count() const
+{
+  long long t;
+  size_t i;
+
+  t = 0;
+  for (i = 0; i < Bits.size(); i++) t += __builtin_popcountll(Bits[i]);
+  return t;
+}
+
+/* ------------------------------------------------------------ */
+/* BitCount */
+
+inline void BitCount::Resize(int rows, int cols, int planes)
+{
+  Rows = rows;
+  Cols = cols;
+  Words = (cols + 63) / 64;
+  Planes = planes;
+  Bits.assign((size_t) Rows * Planes * Words, 0);
+}
+
+inline void BitCount::Clear()
+{
+  Bits.assign(Bits.size(), 0);
+}
+
+inline uint64_t *BitCount::Plane(int r, int b)
+{
+  return Bits.data() + ((size_t) r * Planes + b) * Words;
+}
+
+inline const uint64_t *BitCount::Plane(int r, int b) const
+{
+  return Bits.data() + ((size_t) r * Planes + b) * Words;
+}
+
+inline int BitCount::Get(int r, int c) const
+{
+  int b, v;
+
+  v = 0;
+  for (b = 0; b < Planes; b++) {
+    v |= (int) ((Plane(r, b)[c >> 6] >> (c & 63)) & 1) << b;
+  }
+  return v;
+}
+
+/* ------------------------------------------------------------ */
+/* Kernels */
+
+inline int Bit_Planes_For(int max_count)
+{
+  int p;
+
+  p = 1;
+  while ((1LL << p) <= max_count) p++;
+  return p;
+}
+
+inline void Shift_Row(const uint64_t *src, uint64_t *dst, int words, uint64_t tail_mask, int d)
+{
+  int q, s, w, sw;
+  uint64_t lo, hi;
+
+  q = (d >= 0) ? (d >> 6) : ((-d) >> 6);
+  s = (d >= 0) ? (d & 63) : ((-d) & 63);
+
+  for (w = 0; w < words; w++) {
+    if (d >= 0) {                     /* Pull from higher columns */
+      sw = w + q;
+      lo = (sw < words) ? src[sw] : 0;
+      hi = (sw + 1 < words) ? src[sw+1] : 0;
+      dst[w] = (s == 0) ? lo : ((lo >> s) | (hi << (64 - s)));
+    } else {                          /* Pull from lower columns */
+      sw = w - q;
+      hi = (sw >= 0) ? src[sw] : 0;
+      lo = (sw - 1 >= 0) ? src[sw-1] : 0;
+      dst[w] = (s == 0) ? hi : ((hi << s) | (lo >> (64 - s)));
+    }
+  }
+  if (words > 0) dst[words-1] &= tail_mask;
+}
+
+/* The horizontal counts go into h, one row at a time, by adding each shifted row with
+   a ripple carry.  Then we keep a running sum v of 2e+1 rows of h, adding the row
+   entering the box and subtracting the row leaving it. */
+
+inline void Box_Count(const BitGrid &g, int e, BitCount &out)
+{
+  BitScratch s;
+
+  Box_Count(g, e, out, s);
+}
+
+inline void Box_Count(const BitGrid &g, int e, BitCount &out, BitScratch &s)
+{
+  BitCount &h = s.Counts;
+  std::vector <uint64_t> &carry = s.Row1;
+  std::vector <uint64_t> &x = s.Row2;
+  std::vector <uint64_t> &v = s.Planes;
+  int r, b, d, w, W, P, hp;
+  uint64_t t, a, y, cin;
+
+  W = g.Words;
+  P = out.Planes;
+  hp = Bit_Planes_For(2*e+1);
+  if (hp > P) hp = P;
+  h.Resize(g.Rows, g.Cols, hp);
+  carry.resize(W);
+
+  for (r = 0; r < g.Rows; r++) {
+    for (d = -e; d <= e; d++) {
+      Shift_Row(g.Row(r), carry.data(), W, g.Tail_Mask(), d);
+      for (b = 0; b < hp; b++) {
+        uint64_t *hb = h.Plane(r, b);
+        for (w = 0; w < W; w++) {
+          t = hb[w] & carry[w];
+          hb[w] ^= carry[w];
+          carry[w] = t;
+        }
+      }
+    }
+  }
+
+  /* v holds P planes of the running vertical sum.  x is the carry/borrow row. */
+
+  v.assign((size_t) P * W, 0);
+  x.resize(W);
+
+  for (r = -e; r < g.Rows; r++) {
+
+    /* Add row r+e of h, if it exists. */
+
+    if (r + e < g.Rows) {
+      for (w = 0; w < W; w++) x[w] = 0;
+      for (b = 0; b < P; b++) {
+        for (w = 0; w < W; w++) {
+          a = v[(size_t) b*W + w];
+          y = (b < hp) ? h.Plane(r+e, b)[w] : 0;
+          cin = x[w];
+          v[(size_t) b*W + w] = a ^ y ^ cin;
+          x[w] = (a & y) | (cin & (a ^ y));
+        }
+      }
+    }
+
+    if (r >= 0) {
+      for (b = 0; b < P; b++) {
+        uint64_t *ob = out.Plane(r, b);
+        for (w = 0; w < W; w++) ob[w] = v[(size_t) b*W + w];
+      }
+
+      /* Subtract row r-e of h, if it exists. */
+
+      if (r - e >= 0) {
+        for (w = 0; w < W; w++) x[w] = 0;
+        for (b = 0; b < P; b++) {
+          for (w = 0; w < W; w++) {
+            a = v[(size_t) b*W + w];
+            y = (b < hp) ? h.Plane(r-e, b)[w] : 0;
+            cin = x[w];
+            v[(size_t) b*W + w] = a ^ y ^ cin;
+            x[w] = (~a & y) | (~(a ^ y) & cin);
+          }
+        }
+      }
+    }
+  }
+}
+
+inline void Add_Counts(BitCount &acc, const BitCount &x)
+{
+  BitScratch s;
+
+  Add_Counts(acc, x, s);
+}
+
+inline void Add_Counts(BitCount &acc, const BitCount &x, BitScratch &s)
+{
+  std::vector <uint64_t> &carry = s.Row1;
+  int r, b, w;
+  uint64_t a, y, cin;
+
+  carry.resize(acc.Words);
+  for (r = 0; r < acc.Rows; r++) {
+    for (w = 0; w < acc.Words; w++) carry[w] = 0;
+    for (b = 0; b < acc.Planes; b++) {
+      uint64_t *ab = acc.Plane(r, b);
+      const uint64_t *xb = (b < x.Planes) ? x.Plane(r, b) : NULL;
+      for (w = 0; w < acc.Words; w++) {
+        a = ab[w];
+        y = (xb != NULL) ? xb[w] : 0;
+        cin = carry[w];
+        ab[w] = a ^ y ^ cin;
+        carry[w] = (a & y) | (cin & (a ^ y));
+      }
+    }
+  }
+}
+
+inline void Subtract_Counts(BitCount &acc, const BitCount &x)
+{
+  BitScratch s;
+
+  Subtract_Counts(acc, x, s);
+}
+
+inline void Subtract_Counts(BitCount &acc, const BitCount &x, BitScratch &s)
+{
+  std::vector <uint64_t> &borrow = s.Row1;
+  int r, b, w;
+  uint64_t a, y, bin;
+
+  borrow.resize(acc.Words);
+  for (r = 0; r < acc.Rows; r++) {
+    for (w = 0; w < acc.Words; w++) borrow[w] = 0;
+    for (b = 0; b < acc.Planes; b++) {
+      uint64_t *ab = acc.Plane(r, b);
+      const uint64_t *xb = (b < x.Planes) ? x.Plane(r, b) : NULL;
+      for (w = 0; w < acc.Words; w++) {
+        a = ab[w];
+        y = (xb != NULL) ? xb[w] : 0;
+        bin = borrow[w];
+        ab[w] = a ^ y ^ bin;
+        borrow[w] = (~a & y) | (~(a ^ y) & bin);
+      }
+    }
+  }
+}
+
+/* Compare from the most significant plane down.  gt is set once a cell is known to be
+   bigger than v, and eq is set while the cell is still equal to v. */
+
+inline void At_Least(const BitCount &cnt, int v, BitGrid &out)
+{
+  BitScratch s;
+
+  At_Least(cnt, v, out, s);
+}
+
+inline void At_Least(const BitCount &cnt, int v, BitGrid &out, BitScratch &s)
+{
+  std::vector <uint64_t> &gt = s.Row1;
+  std::vector <uint64_t> &eq = s.Row2;
+  int r, b, w;
+  uint64_t tm;
+
+  if (out.Rows != cnt.Rows || out.Cols != cnt.Cols) out.Resize(cnt.Rows, cnt.Cols);
+  tm = out.Tail_Mask();
+  gt.resize(cnt.Words);
+  eq.resize(cnt.Words);
+
+  for (r = 0; r < cnt.Rows; r++) {
+    uint64_t *orow = out.Row(r);
+    if (v >= (1LL << cnt.Planes)) {
+      for (w = 0; w < cnt.Words; w++) orow[w] = 0;
+      continue;
+    }
+    for (w = 0; w < cnt.Words; w++) { gt[w] = 0; eq[w] = ~0ULL; }
+    for (b = cnt.Planes - 1; b >= 0; b--) {
+      const uint64_t *cb = cnt.Plane(r, b);
+      if ((v >> b) & 1) {
+        for (w = 0; w < cnt.Words; w++) eq[w] &= cb[w];
+      } else {
+        for (w = 0; w < cnt.Words; w++) {
+          gt[w] |= eq[w] & cb[w];
+          eq[w] &= ~cb[w];
+        }
+      }
+    }
+    for (w = 0; w < cnt.Words; w++) orow[w] = gt[w] | eq[w];
+    if (cnt.Words > 0) orow[cnt.Words-1] &= tm;
+  }
+}
+
+inline void Box_Dilate(const BitGrid &g, int e, BitGrid &out)
+{
+  BitScratch s;
+
+  Box_Dilate(g, e, out, s);
+}
+
+inline void Box_Dilate(const BitGrid &g, int e, BitGrid &out, BitScratch &s)
+{
+  BitGrid &h = s.Grid;
+  std::vector <uint64_t> &tmp = s.Row1;
+  int r, rr, d, w, W;
+
+  W = g.Words;
+  h.Resize(g.Rows, g.Cols);
+  tmp.resize(W);
+
+  for (r = 0; r < g.Rows; r++) {
+    uint64_t *hr = h.Row(r);
+    for (d = -e; d <= e; d++) {
+      Shift_Row(g.Row(r), tmp.data(), W, g.Tail_Mask(), d);
+      for (w = 0; w < W; w++) hr[w] |= tmp[w];
+    }
+  }
+
+  out.Resize(g.Rows, g.Cols);
+  for (r = 0; r < g.Rows; r++) {
+    uint64_t *orow = out.Row(r);
+    for (rr = r - e; rr <= r + e; rr++) {
+      if (rr >= 0 && rr < g.Rows) {
+        const uint64_t *hr = h.Row(rr);
+        for (w = 0; w < W; w++) orow[w] |= hr[w];
+      }
+    }
+  }
+}
@@ -0,0 +1,175 @@
+/* Cluster IDs for DBSCAN and 3D DBSCAN, computed from the Core/Border labels.
+
+   Two cores are in the same cluster if one is in the other's window (rows and columns within
+   epsilon, and frames within epsilon_time), or if they're connected by a chain of such cores.
+   A border goes to the cluster of the first core in its window, scanning the frames oldest
+   first, then the rows, then the columns.  Noise doesn't get a cluster.
+
+   Push() takes the labels of each frame (rows*cols characters, row-major), in order.  Each
+   core gets an index, and is unioned with the cores in the part of its window that has
+   already been pushed: the previous epsilon_time frames, the rows above it in its own frame,
+   and the columns to its left in its own row.  That covers every pair of neighboring cores
+   exactly once, and with union by rank and path halving, the whole thing is near-linear in
+   the number of cores.  The core indices of only the last epsilon_time+1 frames are kept (in
+   a ring), so 2D DBSCAN is just epsilon_time = 0.
+
+   After the last frame, Finish() numbers the clusters from 0, in the order in which their
+   first event was pushed, and sets the Cluster of each event.
+
+   This is deliberately a batch computation, for offline analysis.  A later frame can merge
+   two clusters, so no cluster number is final until Finish(), and Events and the union-find
+   arrays grow with every core and border in the recording.  Per-frame cluster IDs for a
+   tracker would have to report merges as they happen, and drop the union-find nodes that
+   have left the window; that isn't done here, which is why bin/3d_dbscan -c can't stream.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <vector>
+
+class Clusters {
+  public:
+    struct Event {
+      int Frame;
+      int Row;
+      int Col;
+      char Label;                            /* 'C' or 'B' */
+      int Core;                              /* The index of its core (or of the core it borders) */
+      int Cluster;                           /* Set by Finish() */
+    };
+
+    std::vector <Event> Events;              /* Every core and border, in the order pushed */
+    int Num_Clusters = 0;                    /* Set by Finish() */
+
+    void Setup(int rows, int cols, int e, int et);
+    void Push(const char *labels);
+    void Finish();
+
+  protected:
+    int Find(int x);
+    void Union(int a, int b);
+
+    int R = 0, C = 0, E = 0, Et = 0;
+    int N = 0;                               /* Frames pushed */
+    std::vector <int> Parent;                /* Union-find over the cores */
+    std::vector <unsigned char> Rank;
+    std::vector < std::vector <int> > Index; /* Ring of e_t+1 frames: each cell's core index, or -1 */
+};
+
+inline void Clusters::Setup(int rows, int cols, int e, int et)
+{
+  R = rows;
+  C = cols;
+  E = e;
+  Et = et;
+  N = 0;
+  Num_Clusters = 0;
+  Events.clear();
+  Parent.clear();
+  Rank.clear();
+  Index.assign(Et+1, std::vector <int> ((size_t) R * C, -1));
+}
+
+inline int Clusters::Find(int x)
+{
+  while (Parent[x] != x) {
+    Parent[x] = Parent[Parent[x]];
+    x = Parent[x];
+  }
+  return x;
+}
+
+inline void Clusters::Union(int a, int b)
+{
+  a = Find(a);
+  b = Find(b);
+  if (a == b) return;
+  if (Rank[a] < Rank[b]) {
+    Parent[a] = b;
+  } else if (Rank[a] > Rank[b]) {
+    Parent[b] = a;
+  } else {
+    Parent[b] = a;
+    Rank[a]++;
+  }
+}
+
+inline void Clusters::Push(const char *labels)
+{
+  int i, j, k, ii, jj, kk, j0, j1, k0, k1, slot, x, core;
+  std::vector <int> *ix;
+  Event ev;
+
+  i = N;
+  slot = i % (Et+1);
+  ix = &Index[slot];
+  ix->assign((size_t) R * C, -1);
+
+  /* Cores first.  The union only looks at cells that have already been indexed. */
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (labels[(size_t) j*C+k] != 'C') continue;
+      core = Parent.size();
+      Parent.push_back(core);
+      Rank.push_back(0);
+      (*ix)[(size_t) j*C+k] = core;
+      ev.Frame = i; ev.Row = j; ev.Col = k; ev.Label = 'C'; ev.Core = core; ev.Cluster = -1;
+      Events.push_back(ev);
+
+      j0 = (j-E < 0) ? 0 : j-E;
+      j1 = (j+E >= R) ? R-1 : j+E;
+      k0 = (k-E < 0) ? 0 : k-E;
+      k1 = (k+E >= C) ? C-1 : k+E;
+      for (ii = (i-Et < 0) ? 0 : i-Et; ii <= i; ii++) {
+        const std::vector <int> &pix = Index[ii % (Et+1)];
+        for (jj = j0; jj <= ((ii == i) ? j : j1); jj++) {
+          for (kk = k0; kk <= k1; kk++) {
+            if (ii == i && jj == j && kk >= k) break;
+            x = pix[(size_t) jj*C+kk];
+            if (x >= 0) Union(core, x);
+          }
+        }
+      }
+    }
+  }
+
+  /* Then borders, which take the first core in their windows. */
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (labels[(size_t) j*C+k] != 'B') continue;
+      j0 = (j-E < 0) ? 0 : j-E;
+      j1 = (j+E >= R) ? R-1 : j+E;
+      k0 = (k-E < 0) ? 0 : k-E;
+      k1 = (k+E >= C) ? C-1 : k+E;
+      core = -1;
+      for (ii = (i-Et < 0) ? 0 : i-Et; ii <= i && core < 0; ii++) {
+        const std::vector <int> &pix = Index[ii % (Et+1)];
+        for (jj = j0; jj <= j1 && core < 0; jj++) {
+          for (kk = k0; kk <= k1 && core < 0; kk++) core = pix[(size_t) jj*C+kk];
+        }
+      }
+      ev.Frame = i; ev.Row = j; ev.Col = k; ev.Label = 'B'; ev.Core = core; ev.Cluster = -1;
+      Events.push_back(ev);
+    }
+  }
+  N++;
+}
+
+inline void Clusters::Finish()
+{
+  std::vector <int> number;
+  size_t i;
+  int root;
+
+  number.assign(Parent.size(), -1);
+  Num_Clusters = 0;
+  for (i = 0; i < Events.size(); i++) {
+    if (Events[i].Core < 0) continue;
+    root = Find(Events[i].Core);
+    if (number[root] == -1) number[root] = Num_Clusters++;
+    Events[i].Cluster = number[root];
+  }
+}
@@ -0,0 +1,86 @@
+/* libdbscan -- the CPU implementations of DBSCAN and 3D DBSCAN, as a library.
+
+   This is what bin/dbscan and bin/3d_dbscan use, so that you can label frames from your own
+   C++ program without spawning a process and parsing its text.  Make lib/libdbscan.a or
+   lib/libdbscan.so, compile with -Iinclude, and link with -Llib -ldbscan -pthread.
+
+   Frames are rows*cols bytes, row-major, where non-zero means On.  You can also give a frame
+   that's already packed into a BitGrid (include/bitgrid.hpp).  Labels are written into a
+   buffer of rows*cols chars that you own, row-major, and each label is 'C' (core), 'B'
+   (border) or '.' (noise or no event) -- the same characters that the programs print.
+   Nothing is allocated for the labels, so you can reuse the same buffer for every frame.
+
+   The engines are LOOP, SAT, BITS and SPARSE, and their labels are identical.  AUTO picks
+   SPARSE or BITS from the fraction of cells that are On in the first frame, and then measures
+   it again every DBSCAN_AUTO_FRAMES frames, so a recording that starts out quiet doesn't stay
+   on SPARSE after the scene gets busy (and vice versa).  See src/libdbscan.cpp for a
+   description of each.  Bad arguments throw std::runtime_error.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "bitgrid.hpp"
+
+class DBSCAN_Engine;
+
+/* A DBSCAN object labels a series of frames with 3D DBSCAN, one frame at a time, as they
+   arrive.  Push() frame i, and it sets the labels of frame i.  Frame i's window only reaches
+   back to frames i-epsilon_t..i, so its labels are final as soon as it is pushed: there are
+   never any earlier frames left to finish, and the labels are identical to running
+   bin/3d_dbscan on the first i+1 frames.  The frames must be pushed in order.  With
+   epsilon_t = 0, each frame is labeled with plain 2D DBSCAN.
+
+   After the first epsilon_t+1 frames, Push() doesn't allocate any memory (except that SPARSE
+   grows its event lists when a frame has more events than any before it).  The exception is
+   when AUTO switches engines: it makes the new engine, and pushes the last 2*epsilon_t frames
+   into it, which is what the cores of the next frame's window depend on, so the labels are
+   the same as if it had used the new engine all along.  To do that, AUTO keeps a copy of the
+   last 2*epsilon_t frames. */
+
+#define DBSCAN_AUTO_FRAMES 32
+
+class DBSCAN {
+  public:
+    DBSCAN(int rows, int cols, int epsilon, int epsilon_t, int minpoints,
+           const std::string &engine = "AUTO");
+    ~DBSCAN();
+    DBSCAN(const DBSCAN &) = delete;
+    DBSCAN &operator=(const DBSCAN &) = delete;
+
+    void Push(const unsigned char *frame, char *labels);
+    void Push(const BitGrid &frame, char *labels);    /* Must be rows x cols */
+
+    int Rows() const;
+    int Cols() const;
+    int Frames() const;                               /* Number of frames pushed */
+    std::string Engine_Name() const;                  /* The engine in use.  AUTO is resolved
+                                                         by the first Push(), and can change. */
+
+  protected:
+    int R, C, E, Et, Mp;
+    int N;
+    std::string Name;
+    DBSCAN_Engine *Engine;
+    BitGrid Packed;                                   /* For frames that come in as bytes */
+
+    bool Auto;                                        /* The engine was AUTO */
+    long long Auto_On;                                /* On cells since the last measurement */
+    int Auto_Frames;                                  /* Frames since the last measurement */
+    std::vector <BitGrid> History;                    /* AUTO: the last 2*epsilon_t frames */
+    std::vector <char> Scratch;                       /* Labels of the frames it replays */
+
+    DBSCAN_Engine *New_Engine(const std::string &name) const;
+    void Switch_Engine(const std::string &name);
+};
+
+/* Label one 2D grid with DBSCAN. */
+
+void DBSCAN_2D(const unsigned char *grid, int rows, int cols, int epsilon, int minpoints,
+               char *labels, const std::string &engine = "AUTO");
+
+/* The engine that AUTO picks, when "on" of "cells" cells are On. */
+
+std::string DBSCAN_Auto_Engine(long long on, long long cells, int epsilon_t);
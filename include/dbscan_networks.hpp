@@ -0,0 +1,2775 @@
+/* The networks that the dbscan_xxx and 3d_dbscan_xxx programs make.  Each program parses
+   its command line, calls Start() on a Network_Builder, calls its function here, and calls
+   Finish().  bin/dbscan_pipeline calls the same functions, with a Network_Builder that
+   writes the binary network to memory, so that it doesn't need the programs or any files.
+
+   The parameters are the programs' command line arguments, in the same order, and they
+   are checked here.  Errors are fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include "neuron_layout.hpp"
+#include "network_builder.hpp"
+
+/* Build a spiking neural network for performing DBSCAN on a full input grid of events,
+   using the flat construction. */
+
+inline void DBSCAN_Flat_Full(Network_Builder &net, int R, int C, int e, int mp)
+{
+  int tr, tc;            // Total rows and columns
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "mp has to be > 1\n"); exit(1); }
+
+  tr = R;
+  tc = C;
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, 0);
+
+  /* Make all of the input neurons -- parameterize these by r and c. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the C_ij neurons -- parameterize these by the inputs to which they correspond */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", mp-1);
+      net.Set_Name(tn, "C[%d][%d]", i, j);
+      neuron_numbers.C(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the core neurons.  Set them as outputs.  */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "B[%d][%d]", i, j);
+      neuron_numbers.B(i, j) = tn;
+      tn++;
+    }
+  }
+  /* Make the Border output neurons. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Output(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Border[%d][%d]", i, j);
+      neuron_numbers.Border(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        for (c = -e; c <= e; c++) {
+          if (r != 0 || c != 0) {
+            to = neuron_numbers.C(i+r, j+c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from each I and C to its core for timestep */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.Core(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+      from = neuron_numbers.C(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Now the synapses from the cores to the B's */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      if (from != -1) {
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            if (r != 0 || c != 0) {
+              to = neuron_numbers.B(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, all of the synapses to the borders. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      to = neuron_numbers.Border(i, j);
+      if (to != -1) {
+        from = neuron_numbers.I(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 4);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+        from = neuron_numbers.Core(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", -1);
+        from = neuron_numbers.B(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a partial grid of events,
+   using the flat construction. */
+
+inline void DBSCAN_Flat_Partial(Network_Builder &net, int I_R, int I_C, int e, int mp)
+{
+  int tr, tc;            // Total rows and columns
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "mp has to be > 1\n"); exit(1); }
+
+  tr = I_R + 4 * e;
+  tc = I_C + 4 * e;
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, 0);
+
+  /* Make all of the input neurons -- parameterize these by r and c. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the C_ij neurons -- parameterize these by the inputs to which they correspond */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", mp-1);
+      net.Set_Name(tn, "C[%d][%d]", i, j);
+      neuron_numbers.C(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the core neurons.  Don't set the outputs yet.  */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Now set only the inner I_R x I_C core neurons to be outputs. */
+
+  for (i = e*2; i < tr - e*2; i++) {
+    for (j = e*2; j < tc - e*2; j++) {
+      net.Add_Output(neuron_numbers.Core(i, j));
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "B[%d][%d]", i, j);
+      neuron_numbers.B(i, j) = tn;
+      tn++;
+    }
+  }
+  /* Make the Border output neurons. */
+
+  for (i = e*2; i < tr - e*2; i++) {
+    for (j = e*2; j < tc - e*2; j++) {
+      net.Add_Node(tn);
+      net.Add_Output(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Border[%d][%d]", i, j);
+      neuron_numbers.Border(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        for (c = -e; c <= e; c++) {
+          if (r != 0 || c != 0) {
+            to = neuron_numbers.C(i+r, j+c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from each I and C to its core for timestep */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.Core(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+      from = neuron_numbers.C(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Now the synapses from the cores to the B's */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      if (from != -1) {
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            if (r != 0 || c != 0) {
+              to = neuron_numbers.B(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, all of the synapses to the borders. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      to = neuron_numbers.Border(i, j);
+      if (to != -1) {
+        from = neuron_numbers.I(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 4);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+        from = neuron_numbers.Core(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", -1);
+        from = neuron_numbers.B(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on an input grid of events,
+   using the systolic construction. */
+
+inline void DBSCAN_Systolic_Full(Network_Builder &net, int R, int e, int mp)
+{
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "minPts has to be > 1\n"); exit(1); }
+  if (R < 1) { fprintf(stderr, "R has to be > 0\n"); exit(1); }
+  if (e < 1) { fprintf(stderr, "e has to be > 0\n"); exit(1); }
+
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, R + e + 1, -2*e, 2*e + 1, 0);
+
+  /* Make all of the input neurons.
+     I'm creating them in column-major order rather than row-major, so the inputs are consecutive
+     starting at zero. (The internals are still row-major). */
+
+  for (j = e; j >= -e; j--) {
+    for (i = 0; i < R; i++) {
+
+      net.Add_Node(tn);
+      if (j == e) net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* The C neurons.  */
+
+  for (i = 0; i < R; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", mp-1);
+    net.Set_Name(tn, "C[%d][%d]", i, j);
+    neuron_numbers.C(i, j) = tn;
+    tn++;
+  }
+
+  /* There are 2e+1 columns of Core neurons, but only the first column are outputs.
+     For that reason, I'm going to create them in column major order. 
+     Plus -- the neurons in all columns but e have thresholds of 1, since they are
+     simply receiving spikes from their previous column. */
+
+  for (j = e; j >= -e; j--) {
+    for (i = 0; i < R; i++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", (j == e) ? 2 : 1);
+      if (j == e) net.Add_Output(tn);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = 0; i < R; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", 1);
+    net.Set_Name(tn, "B[%d][%d]", i, j);
+    neuron_numbers.B(i, j) = tn;
+    tn++;
+  }
+
+  /* Make the Border output neurons.  Also one column of these. */
+
+  for (i = 0; i < R; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Add_Output(tn);
+    net.Set_Node_Property(tn, "Threshold", 2);
+    net.Set_Name(tn, "Border[%d][%d]", i, j);
+    neuron_numbers.Border(i, j) = tn;
+    tn++;
+  }
+
+  /* Create the synapses from each I neuron to the next I neuron in the row. */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j > -e; j--) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.I(i, j-1);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j >= -e; j--) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != 0) {
+          to = neuron_numbers.C(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from the center I's, and C neurons, to the output core. */
+
+  for (i = 0; i < R; i++) {
+    from = neuron_numbers.I(i, 0);
+    to = neuron_numbers.Core(i, e);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 1 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.C(i, 0);
+    to = neuron_numbers.Core(i, e);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 2 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+
+  /* Create the synapses from each core to the next in line. */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j > -e; j--) {
+      from = neuron_numbers.Core(i, j);
+      to = neuron_numbers.Core(i, j-1);
+      if (from == -1 || to == -1) {
+        fprintf(stderr, "Internal error 3 -- from (%d) or to (%d) = -1\n", from, to);
+        exit(1);
+      }
+      net.Add_Edge(from, to);
+      net.Set_Edge_Property(from, to, "Delay", 1);
+      net.Set_Edge_Property(from, to, "Weight", 1);
+    }
+  }
+
+  /* Now from the Cores to the B's. */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j >= -e; j--) {
+      from = neuron_numbers.Core(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != 0) {
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, from the B's, the center core and the center input to the border */
+
+  for (i = 0; i < R; i++) {
+    from = neuron_numbers.I(i, -e);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 4 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+
+    /* Center input takes 2 to get to Core, but then e to get to Core[r][e], then
+       two more to get to the border. */
+
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 4);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.Core(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 5 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", -1);
+
+    from = neuron_numbers.B(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 6 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a partial input grid of events,
+   using the systolic construction. */
+
+inline void DBSCAN_Systolic_Partial(Network_Builder &net, int I_R, int e, int mp)
+{
+  int tr, tc;            // Total rows and columns
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "minPts has to be > 1\n"); exit(1); }
+  if (I_R < 1) { fprintf(stderr, "I_R has to be > 0\n"); exit(1); }
+  if (e < 1) { fprintf(stderr, "e has to be > 0\n"); exit(1); }
+
+  tc = 2 * e + 1;
+  tr = 4 * e + I_R;
+
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, 0);
+
+  /* Make all of the input neurons.
+     I'm creating them in column-major order rather than row-major, so the inputs are consecutive
+     starting at zero. (The internals are still row-major. */
+
+  for (j = 0; j < tc; j++) {
+    for (i = 0; i < tr; i++) {
+
+      net.Add_Node(tn);
+      if (j == 0) net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* The C neurons.  Now, there is only one C neuron per row, and none in the top and bottom e rows. */
+
+  for (i = e; i < tr-e; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", mp-1);
+    net.Set_Name(tn, "C[%d][%d]", i, j);
+    neuron_numbers.C(i, j) = tn;
+    tn++;
+  }
+
+  /* There are 2e+1 columns of Core neurons, but only the first column and middle I_R of them are outputs.
+     For that reason, I'm going to create them in column major order. 
+     Plus -- the neurons in all columns but 0 have thresholds of 1, since they are
+     simply receiving spikes from their previous column. */
+
+  for (j = 0; j < tc; j++) {
+    for (i = e; i < tr-e; i++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", (j == 0) ? 2 : 1);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      if (i >= 2*e && i < tr - 2*e && j == 0) net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons - there is just one column of them, and they only exist for the middle I_R rows. */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", 1);
+    net.Set_Name(tn, "B[%d][%d]", i, j);
+    neuron_numbers.B(i, j) = tn;
+    tn++;
+  }
+
+  /* Make the Border output neurons.  Also one column of these. */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Add_Output(tn);
+    net.Set_Node_Property(tn, "Threshold", 2);
+    net.Set_Name(tn, "Border[%d][%d]", i, j);
+    neuron_numbers.Border(i, j) = tn;
+    tn++;
+  }
+
+  /* Create the synapses from each I neuron to the next I neuron in the row. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.I(i, j+1);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != e) {
+          to = neuron_numbers.C(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from the center I's, and C neurons, to the output core. */
+
+  for (i = e; i < tr-e; i++) {
+    from = neuron_numbers.I(i, e);
+    to = neuron_numbers.Core(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 1 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.C(i, 0);
+    to = neuron_numbers.Core(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 2 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+
+  /* Create the synapses from each core to the next in line. */
+
+  for (i = e; i < tr-e; i++) {
+    for (j = 1; j < tc; j++) {
+      from = neuron_numbers.Core(i, j-1);
+      to = neuron_numbers.Core(i, j);
+      if (from == -1 || to == -1) {
+        fprintf(stderr, "Internal error 3 -- from (%d) or to (%d) = -1\n", from, to);
+        exit(1);
+      }
+      net.Add_Edge(from, to);
+      net.Set_Edge_Property(from, to, "Delay", 1);
+      net.Set_Edge_Property(from, to, "Weight", 1);
+    }
+  }
+
+  /* Now from the Cores to the B's. */
+
+  for (i = e; i < tr-e; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != e) {
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, from the B's, the center core and the right input to the border */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    from = neuron_numbers.I(i, e*2);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 4 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+
+    /* Center input takes 2 to get to Core, but then e to get to Core[r][e], then
+       two more to get to the border. */
+
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 4);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.Core(i, e);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 5 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", -1);
+
+    from = neuron_numbers.B(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 6 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a full input grid of events,
+   using the 3D flat construction. */
+
+inline void DBSCAN_3D_Flat_Full(Network_Builder &net, int R, int C, int e, int e_t, int mp)
+{
+  int tr, tc;
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c, mem_layer;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "mp has to be > 1\n"); exit(1); }
+
+  tr = R;
+  tc = C;
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, e_t);
+
+  /* Make all of the input neurons -- parameterize these by r and c. */
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the C_ij neurons -- parameterize these by the inputs to which they correspond */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", mp-1);
+      net.Set_Name(tn, "C[%d][%d]", i, j);
+      neuron_numbers.C(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the core neurons.  Set them as outputs.  */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "B[%d][%d]", i, j);
+      neuron_numbers.B(i, j) = tn;
+      tn++;
+    }
+  }
+  /* Make the Border output neurons. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Output(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Border[%d][%d]", i, j);
+      neuron_numbers.Border(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Add Input memory neurons. They are parameterized by r, c, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of input deeper into the 
+     network's execution. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) { 
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_I%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_I[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Add Core memory neurons.  They are parameterized by r, c, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of core classifications deeper 
+     into the network's execution.
+  */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) { 
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_Core%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_Core[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        for (c = -e; c <= e; c++) {
+          if (r != 0 || c != 0) {
+            to = neuron_numbers.C(i+r, j+c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to C neurons*/
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            //if (r != 0 || c != 0) { // We consider a past event at i_j in the neighborhood of current event r_c
+              to = neuron_numbers.C(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            //}
+          }
+        }
+      }
+    }
+  }
+
+   /* Connect synapses from all Mem_Core layers to the B neurons*/
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            //if (r != 0 || c != 0) { // Mem_Core to B neurons...prior event E_{r,c,t-x} *is in* current event E{r,c,t}'s neighborhood... 
+              to = neuron_numbers.B(i+r, j+c); 
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1); 
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            //}
+          }
+        }
+      }
+    }
+  }
+  
+  /* Add synapses from all Mem_Core layers to successive Mem_Core layers. Think of this as the Core classifications cascading
+     down through the layers. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) { 
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        if (mem_layer == 0) {
+          from = neuron_numbers.Core(i, j);
+        } else {
+          from = neuron_numbers.Mem_Core[mem_layer - 1](i, j);
+        }
+        
+        to = neuron_numbers.Mem_Core[mem_layer](i, j);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to successive Mem_I layers. Think of this as the input cascading
+     down through the layers. */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        if (mem_layer == 0) {
+          from = neuron_numbers.I(i, j);
+        } else {
+          from = neuron_numbers.Mem_I[mem_layer - 1](i, j);
+        }
+        to = neuron_numbers.Mem_I[mem_layer](i, j);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }     
+      }
+    }
+  }
+
+  /* Create the synapses from each I and C to its core for timestep */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.Core(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+      from = neuron_numbers.C(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Now the synapses from the cores to the B's */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      if (from != -1) {
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            if (r != 0 || c != 0) {
+              to = neuron_numbers.B(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, all of the synapses to the borders. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      to = neuron_numbers.Border(i, j);
+      if (to != -1) {
+        from = neuron_numbers.I(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 4);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+        from = neuron_numbers.Core(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", -1);
+        from = neuron_numbers.B(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a partial input grid of events,
+   using the 3D flat construction. */
+
+inline void DBSCAN_3D_Flat_Partial(Network_Builder &net, int I_R, int I_C, int e, int e_t, int mp)
+{
+  int tr, tc;
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c, mem_layer;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "mp has to be > 1\n"); exit(1); }
+
+  tr = I_R + 4 * e;
+  tc = I_C + 4 * e;
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, e_t);
+
+  /* Make all of the input neurons -- parameterize these by r and c. */
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the C_ij neurons -- parameterize these by the inputs to which they correspond */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", mp-1);
+      net.Set_Name(tn, "C[%d][%d]", i, j);
+      neuron_numbers.C(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the core neurons.  Don't set them as outputs yet.  */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      //net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Now set only the inner I_R x I_C core neurons to be outputs. */
+
+  for (i = e*2; i < tr - e*2; i++) {
+    for (j = e*2; j < tc - e*2; j++) {
+      net.Add_Output(neuron_numbers.Core(i, j));
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "B[%d][%d]", i, j);
+      neuron_numbers.B(i, j) = tn;
+      tn++;
+    }
+  }
+  /* Make the Border output neurons. */
+
+  for (i = e*2; i < tr - e*2; i++) {
+    for (j = e*2; j < tc - e*2; j++) {
+      net.Add_Node(tn);
+      net.Add_Output(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Border[%d][%d]", i, j);
+      neuron_numbers.Border(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Add Input memory neurons. They are parameterized by r, c, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of input deeper into the 
+     network's execution. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) { 
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_I%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_I[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Add Core memory neurons.  They are parameterized by r, c, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of core classifications deeper 
+     into the network's execution.
+  */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = e; i < tr - e; i++) {
+      for (j = e; j < tc - e; j++) { 
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_Core%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_Core[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        for (c = -e; c <= e; c++) {
+          if (r != 0 || c != 0) {
+            to = neuron_numbers.C(i+r, j+c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to C neurons*/
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            //if (r != 0 || c != 0) { // We consider a past event at i_j in the neighborhood of current event r_c
+              to = neuron_numbers.C(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            //}
+          }
+        }
+      }
+    }
+  }
+
+   /* Connect synapses from all Mem_Core layers to the B neurons*/
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j); 
+        if (from != -1){
+          for (r = -e; r <= e; r++) {
+            for (c = -e; c <= e; c++) {
+              //if (r != 0 || c != 0) { // Mem_Core to B neurons...prior event E_{r,c,t-x} *is in* current event E{r,c,t}'s neighborhood... 
+                to = neuron_numbers.B(i+r, j+c); 
+                if (to != -1) {
+                  net.Add_Edge(from, to);
+                  net.Set_Edge_Property(from, to, "Delay", 1); 
+                  net.Set_Edge_Property(from, to, "Weight", 1);
+                }
+              //}
+            }
+          }
+        }
+      }
+    }
+  }
+  
+  /* Add synapses from all Mem_Core layers to successive Mem_Core layers. Think of this as the Core classifications cascading
+     down through the layers. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) { 
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        if (mem_layer == 0) {
+          from = neuron_numbers.Core(i, j);
+        } else {
+          from = neuron_numbers.Mem_Core[mem_layer - 1](i, j);
+        }
+        
+        to = neuron_numbers.Mem_Core[mem_layer](i, j);
+        if (to != -1 && from != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to successive Mem_I layers. Think of this as the input cascading
+     down through the layers. */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        if (mem_layer == 0) {
+          from = neuron_numbers.I(i, j);
+        } else {
+          from = neuron_numbers.Mem_I[mem_layer - 1](i, j);
+        }
+        to = neuron_numbers.Mem_I[mem_layer](i, j);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }     
+      }
+    }
+  }
+
+  /* Create the synapses from each I and C to its core for timestep */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.Core(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+      from = neuron_numbers.C(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Now the synapses from the cores to the B's */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      if (from != -1) {
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            if (r != 0 || c != 0) {
+              to = neuron_numbers.B(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, all of the synapses to the borders. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      to = neuron_numbers.Border(i, j);
+      if (to != -1) {
+        from = neuron_numbers.I(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 4);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+        from = neuron_numbers.Core(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", -1);
+        from = neuron_numbers.B(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a partial input grid of events,
+   using the 3D flat construction. */
+
+inline void DBSCAN_3D_Flat_Partial_Stream(Network_Builder &net, int R, int C, int I_R, int I_C, int e, int e_t, int mp)
+{
+  int tr, tc;
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c, mem_layer;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "mp has to be > 1\n"); exit(1); }
+
+  tr = I_R + 4 * e;
+  tc = I_C + 4 * e;
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, e_t);
+
+  /* Make all of the input neurons -- parameterize these by r and c. */
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      net.Add_Node(tn);
+      net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the C_ij neurons -- parameterize these by the inputs to which they correspond */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", mp-1);
+      net.Set_Name(tn, "C[%d][%d]", i, j);
+      neuron_numbers.C(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make all of the core neurons.  Don't set them as outputs yet.  */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      //net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Now set only the inner I_R x I_C core neurons to be outputs. */
+
+  for (i = e*2; i < tr - e*2; i++) {
+    for (j = e*2; j < tc - e*2; j++) {
+      net.Add_Output(neuron_numbers.Core(i, j));
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = e; i < tr - e; i++) {
+    for (j = e; j < tc - e; j++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "B[%d][%d]", i, j);
+      neuron_numbers.B(i, j) = tn;
+      tn++;
+    }
+  }
+  /* Make the Border output neurons. */
+
+  for (i = e*2; i < tr - e*2; i++) {
+    for (j = e*2; j < tc - e*2; j++) {
+      net.Add_Node(tn);
+      net.Add_Output(tn);
+      net.Set_Node_Property(tn, "Threshold", 2);
+      net.Set_Name(tn, "Border[%d][%d]", i, j);
+      neuron_numbers.Border(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Add Input memory neurons. They are parameterized by r, c, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of input deeper into the 
+     network's execution. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) { 
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_I%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_I[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Add Core memory neurons.  They are parameterized by r, c, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of core classifications deeper 
+     into the network's execution.
+  */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = e; i < tr - e; i++) {
+      for (j = e; j < tc - e; j++) { 
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_Core%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_Core[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        for (c = -e; c <= e; c++) {
+          if (r != 0 || c != 0) {
+            to = neuron_numbers.C(i+r, j+c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to C neurons*/
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            //if (r != 0 || c != 0) { // We consider a past event at i_j in the neighborhood of current event r_c
+              to = neuron_numbers.C(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            //}
+          }
+        }
+      }
+    }
+  }
+
+   /* Connect synapses from all Mem_Core layers to the B neurons*/
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j); 
+        if (from != -1){
+          for (r = -e; r <= e; r++) {
+            for (c = -e; c <= e; c++) {
+              //if (r != 0 || c != 0) { // Mem_Core to B neurons...prior event E_{r,c,t-x} *is in* current event E{r,c,t}'s neighborhood... 
+                to = neuron_numbers.B(i+r, j+c); 
+                if (to != -1) {
+                  net.Add_Edge(from, to);
+                  net.Set_Edge_Property(from, to, "Delay", 1); 
+                  net.Set_Edge_Property(from, to, "Weight", 1);
+                }
+              //}
+            }
+          }
+        }
+      }
+    }
+  }
+  
+  /* Add synapses from all Mem_Core layers to successive Mem_Core layers. Think of this as the Core classifications cascading
+     down through the layers. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) { 
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        if (mem_layer == 0) {
+          from = neuron_numbers.Core(i, j);
+        } else {
+          from = neuron_numbers.Mem_Core[mem_layer - 1](i, j);
+        }
+        
+        to = neuron_numbers.Mem_Core[mem_layer](i, j);
+        if (to != -1 && from != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", (int)(ceil(R * 1.0 / I_R) * ceil(C * 1.0 / I_C)));
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to successive Mem_I layers. Think of this as the input cascading
+     down through the layers. */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        if (mem_layer == 0) {
+          from = neuron_numbers.I(i, j);
+        } else {
+          from = neuron_numbers.Mem_I[mem_layer - 1](i, j);
+        }
+        to = neuron_numbers.Mem_I[mem_layer](i, j);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", (int) (ceil(R * 1.0 / I_R) * ceil(C * 1.0 / I_C)));
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }     
+      }
+    }
+  }
+
+  /* Create the synapses from each I and C to its core for timestep */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.Core(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+      from = neuron_numbers.C(i, j);
+      if (from != -1 && to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Now the synapses from the cores to the B's */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      if (from != -1) {
+        for (r = -e; r <= e; r++) {
+          for (c = -e; c <= e; c++) {
+            if (r != 0 || c != 0) {
+              to = neuron_numbers.B(i+r, j+c);
+              if (to != -1) {
+                net.Add_Edge(from, to);
+                net.Set_Edge_Property(from, to, "Delay", 1);
+                net.Set_Edge_Property(from, to, "Weight", 1);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Finally, all of the synapses to the borders. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      to = neuron_numbers.Border(i, j);
+      if (to != -1) {
+        from = neuron_numbers.I(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 4);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+        from = neuron_numbers.Core(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 2);
+        net.Set_Edge_Property(from, to, "Weight", -1);
+        from = neuron_numbers.B(i, j);
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on an input grid of events,
+   using the systolic construction. */
+
+inline void DBSCAN_3D_Systolic_Full(Network_Builder &net, int R, int C, int e, int e_t, int mp)
+{
+  int mem_layer;
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to, delay;
+
+  if (mp <= 1) { fprintf(stderr, "minPts has to be > 1\n"); exit(1); }
+  if (R < 1) { fprintf(stderr, "R has to be > 0\n"); exit(1); }
+  if (C < 1) { fprintf(stderr, "C has to be > 0\n"); exit(1); }
+  if (e < 1) { fprintf(stderr, "e has to be > 0\n"); exit(1); }
+  if (e_t < 1) { fprintf(stderr, "e_t has to be > 0\n"); exit(1); }
+
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, R + e + 1, -2*e, 2*e + 1, e_t);
+
+  /* Make all of the input neurons.
+     I'm creating them in column-major order rather than row-major, so the inputs are consecutive
+     starting at zero. (The internals are still row-major). */
+
+  for (j = e; j >= -e; j--) {
+    for (i = 0; i < R; i++) {
+
+      net.Add_Node(tn);
+      if (j == e) net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* The C neurons.  */
+
+  for (i = 0; i < R; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", mp-1);
+    net.Set_Name(tn, "C[%d][%d]", i, j);
+    neuron_numbers.C(i, j) = tn;
+    tn++;
+  }
+
+  /* There are 2e+1 columns of Core neurons, but only the first column are outputs.
+     For that reason, I'm going to create them in column major order. 
+     Plus -- the neurons in all columns but e have thresholds of 1, since they are
+     simply receiving spikes from their previous column. */
+
+  for (j = e; j >= -e; j--) {
+    for (i = 0; i < R; i++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", (j == e) ? 2 : 1);
+      if (j == e) net.Add_Output(tn);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons. */
+
+  for (i = 0; i < R; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", 1);
+    net.Set_Name(tn, "B[%d][%d]", i, j);
+    neuron_numbers.B(i, j) = tn;
+    tn++;
+  }
+
+  /* Make the Border output neurons.  Also one column of these. */
+
+  for (i = 0; i < R; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Add_Output(tn);
+    net.Set_Node_Property(tn, "Threshold", 2);
+    net.Set_Name(tn, "Border[%d][%d]", i, j);
+    neuron_numbers.Border(i, j) = tn;
+    tn++;
+  }
+
+  /* Add 2e+1 columns of Input memory neurons. They are parameterized by r, e and e_t.
+     Think of these neurons as columns of neurons of size r that persist prior ``frames''  
+     of input deeper into the network's execution. Allows for systolic to work temporally, too. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (j = e; j >= -e; j--) {
+      for (i = 0; i < R; i++) {
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_I%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_I[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+    /* Add 2e+1 columns of Core memory neurons.  They are parameterized by r, e, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of core classifications deeper 
+     into the network's execution.
+  */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (j = e; j >= -e; j--) {
+      for (i = 0; i < R; i++) {
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_Core%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_Core[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+  
+
+  /* Create the synapses from each I neuron to the next I neuron in the row. */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j > -e; j--) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.I(i, j-1);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_Core cols to successive Mem_Core cols and Mem_I cols
+    to successive Mem_I cols. This mirrors what is done with the I neurons above */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) { 
+    for (i = 0; i < R; i++) {
+      for (j = e; j > -e; j--) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        to = neuron_numbers.Mem_Core[mem_layer](i, j-1);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }
+
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        to = neuron_numbers.Mem_I[mem_layer](i, j-1);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        } 
+
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to successive Mem_I layers. Do the same for
+     Mem_Core layers. There are e_t layers. This is wiring up the frames over time
+     so that earlier activity may feed back into the current frame.*/
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < R; i++) {
+      j = e; //First col (to which inputs are applied for I neurons)
+      delay = C + (2 * e) + 4; 
+
+      if (mem_layer == 0) {
+        from = neuron_numbers.I(i, j);
+      } else {
+        from = neuron_numbers.Mem_I[mem_layer - 1](i, j);
+      }
+
+      to = neuron_numbers.Mem_I[mem_layer](i, j);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", delay);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }     
+
+      // now for the Mem_Core neurons...
+      if (mem_layer == 0) {
+        from = neuron_numbers.Core(i, j);
+      } else {
+        from = neuron_numbers.Mem_Core[mem_layer - 1](i, j);
+      }
+
+      to = neuron_numbers.Mem_Core[mem_layer](i, j);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", delay);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      } 
+
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j >= -e; j--) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != 0) {
+          to = neuron_numbers.C(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from each Mem_I neuron to the C neurons */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < R; i++) {
+      for (j = e; j >= -e; j--) {
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          c = 0;
+          //if (r != 0 || j != 0) {
+            to = neuron_numbers.C(i+r, c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          //}
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from the center I's, and C neurons, to the output core. */
+
+  for (i = 0; i < R; i++) {
+    from = neuron_numbers.I(i, 0);
+    to = neuron_numbers.Core(i, e);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 1 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.C(i, 0);
+    to = neuron_numbers.Core(i, e);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 2 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+
+  /* Create the synapses from each core to the next in line. */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j > -e; j--) {
+      from = neuron_numbers.Core(i, j);
+      to = neuron_numbers.Core(i, j-1);
+      if (from == -1 || to == -1) {
+        fprintf(stderr, "Internal error 3 -- from (%d) or to (%d) = -1\n", from, to);
+        exit(1);
+      }
+      net.Add_Edge(from, to);
+      net.Set_Edge_Property(from, to, "Delay", 1);
+      net.Set_Edge_Property(from, to, "Weight", 1);
+    }
+  }
+
+  /* Now from the Cores to the B's. */
+
+  for (i = 0; i < R; i++) {
+    for (j = e; j >= -e; j--) {
+      from = neuron_numbers.Core(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != 0) {
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Now from the Mem_Cores to the B's. */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < R; i++) {
+      for (j = e; j >= -e; j--) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          c = 0;
+          //if (r != 0 || j != 0) { // Mem_Core to B neurons...prior event E_{r,c,t-x} *is in* current event E{r,c,t}'s neighborhood...
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+          //}
+        }
+      }
+    }
+  }
+
+  /* Finally, from the B's, the center core and the center input to the border */
+
+  for (i = 0; i < R; i++) {
+    from = neuron_numbers.I(i, -e);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 4 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+
+    /* Center input takes 2 to get to Core, but then e to get to Core[r][e], then
+       two more to get to the border. */
+
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 4);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.Core(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 5 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", -1);
+
+    from = neuron_numbers.B(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 6 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a partial input grid of events,
+   using the systolic construction. */
+
+inline void DBSCAN_3D_Systolic_Partial(Network_Builder &net, int I_R, int I_C, int e, int e_t, int mp)
+{
+  int mem_layer, delay;
+  int tr, tc;            // Total rows and columns
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "minPts has to be > 1\n"); exit(1); }
+  if (I_R < 1) { fprintf(stderr, "I_R has to be > 0\n"); exit(1); }
+  if (I_C < 1) { fprintf(stderr, "I_C has to be > 0\n"); exit(1); }
+  if (e < 1) { fprintf(stderr, "e has to be > 0\n"); exit(1); }
+  if (e_t < 1) { fprintf(stderr, "e_t has to be > 0\n"); exit(1); }
+
+  tc = 2 * e + 1;
+  tr = 4 * e + I_R;
+
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, e_t);
+
+  /* Make all of the input neurons.
+     I'm creating them in column-major order rather than row-major, so the inputs are consecutive
+     starting at zero. (The internals are still row-major. */
+
+  for (j = 0; j < tc; j++) {
+    for (i = 0; i < tr; i++) {
+
+      net.Add_Node(tn);
+      if (j == 0) net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* The C neurons.  Now, there is only one C neuron per row, and none in the top and bottom e rows. */
+
+  for (i = e; i < tr-e; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", mp-1);
+    net.Set_Name(tn, "C[%d][%d]", i, j);
+    neuron_numbers.C(i, j) = tn;
+    tn++;
+  }
+
+  /* There are 2e+1 columns of Core neurons, but only the first column and middle I_R of them are outputs.
+     For that reason, I'm going to create them in column major order. 
+     Plus -- the neurons in all columns but 0 have thresholds of 1, since they are
+     simply receiving spikes from their previous column. */
+
+  for (j = 0; j < tc; j++) {
+    for (i = e; i < tr-e; i++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", (j == 0) ? 2 : 1);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      if (i >= 2*e && i < tr - 2*e && j == 0) net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons - there is just one column of them, and they only exist for the middle I_R rows. */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", 1);
+    net.Set_Name(tn, "B[%d][%d]", i, j);
+    neuron_numbers.B(i, j) = tn;
+    tn++;
+  }
+
+  /* Make the Border output neurons.  Also one column of these. */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Add_Output(tn);
+    net.Set_Node_Property(tn, "Threshold", 2);
+    net.Set_Name(tn, "Border[%d][%d]", i, j);
+    neuron_numbers.Border(i, j) = tn;
+    tn++;
+  }
+
+  /* Add 2e+1 columns of Input memory neurons. They are parameterized by r, e and e_t.
+     Think of these neurons as columns of neurons of size r that persist prior ``frames''  
+     of input deeper into the network's execution. Allows for systolic to work temporally, too. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (j = 0; j < tc; j++) {
+      for (i = 0; i < tr; i++) {
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_I%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_I[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+    /* Add 2e+1 columns of Core memory neurons.  They are parameterized by r, e, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of core classifications deeper 
+     into the network's execution.
+  */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (j = 0; j < tc; j++) {
+      for (i = e; i < tr - e; i++) {
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_Core%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_Core[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Create the synapses from each I neuron to the next I neuron in the row. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.I(i, j+1);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_Core cols to successive Mem_Core cols and Mem_I cols
+    to successive Mem_I cols. This mirrors what is done with the I neurons above */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) { 
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        to = neuron_numbers.Mem_Core[mem_layer](i, j+1);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }
+
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        to = neuron_numbers.Mem_I[mem_layer](i, j+1);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        } 
+
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to successive Mem_I layers. Do the same for
+     Mem_Core layers. There are e_t layers. This is wiring up the frames over time
+     so that earlier activity may feed back into the current frame.*/
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      j = 0; //First col (to which inputs are applied for I neurons)
+      delay = I_C + (4 * e) + 4; 
+
+      if (mem_layer == 0) {
+        from = neuron_numbers.I(i, j);
+      } else {
+        from = neuron_numbers.Mem_I[mem_layer - 1](i, j);
+      }
+
+      to = neuron_numbers.Mem_I[mem_layer](i, j);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", delay);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }     
+
+      // now for the Mem_Core neurons...
+      if (mem_layer == 0) {
+        from = neuron_numbers.Core(i, j);
+      } else {
+        from = neuron_numbers.Mem_Core[mem_layer - 1](i, j);
+      }
+
+      to = neuron_numbers.Mem_Core[mem_layer](i, j);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", delay);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      } 
+
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != e) {
+          to = neuron_numbers.C(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from each Mem_I neuron to the C neurons */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          c = 0;
+          //if (r != 0 || j != 0) {
+            to = neuron_numbers.C(i+r, c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          //}
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from the center I's, and C neurons, to the output core. */
+
+  for (i = e; i < tr-e; i++) {
+    from = neuron_numbers.I(i, e);
+    to = neuron_numbers.Core(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 1 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.C(i, 0);
+    to = neuron_numbers.Core(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 2 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+
+  /* Create the synapses from each core to the next in line. */
+
+  for (i = e; i < tr-e; i++) {
+    for (j = 1; j < tc; j++) {
+      from = neuron_numbers.Core(i, j-1);
+      to = neuron_numbers.Core(i, j);
+      if (from == -1 || to == -1) {
+        fprintf(stderr, "Internal error 3 -- from (%d) or to (%d) = -1\n", from, to);
+        exit(1);
+      }
+      net.Add_Edge(from, to);
+      net.Set_Edge_Property(from, to, "Delay", 1);
+      net.Set_Edge_Property(from, to, "Weight", 1);
+    }
+  }
+
+  /* Now from the Cores to the B's. */
+
+  for (i = e; i < tr-e; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != e) {
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Now from the Mem_Cores to the B's. */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = e; i < tr - e; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          c = 0;
+          //if (r != 0 || j != 0) { // Mem_Core to B neurons...prior event E_{r,c,t-x} *is in* current event E{r,c,t}'s neighborhood...
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+          //}
+        }
+      }
+    }
+  }
+
+  /* Finally, from the B's, the center core and the right input to the border */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    from = neuron_numbers.I(i, e*2);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 4 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+
+    /* Center input takes 2 to get to Core, but then e to get to Core[r][e], then
+       two more to get to the border. */
+
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 4);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.Core(i, e);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 5 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", -1);
+
+    from = neuron_numbers.B(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 6 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+}
+
+/* ------------------------------------------------------------ */
+
+/* Build a spiking neural network for performing DBSCAN on a partial input grid of events,
+   using the systolic construction, over the entire frame.
+   
+   This "stream" variant is intended to be used for real-time, continuous processing.
+   */
+
+inline void DBSCAN_3D_Systolic_Partial_Stream(Network_Builder &net, int R, int C, int I_R, int I_C, int e, int e_t, int mp)
+{
+  int mem_layer, delay;
+  int tr, tc;            // Total rows and columns
+  Neuron_Layout neuron_numbers;
+  int tn;
+  int i, j, r, c;
+  int from, to;
+
+  if (mp <= 1) { fprintf(stderr, "minPts has to be > 1\n"); exit(1); }
+  if (I_R < 1) { fprintf(stderr, "I_R has to be > 0\n"); exit(1); }
+  if (I_C < 1) { fprintf(stderr, "I_C has to be > 0\n"); exit(1); }
+  if (e < 1) { fprintf(stderr, "e has to be > 0\n"); exit(1); }
+  if (e_t < 1) { fprintf(stderr, "e_t has to be > 0\n"); exit(1); }
+
+  tc = 2 * e + 1; //Delay likely needs to be a function of this....
+  tr = 4 * e + I_R;
+
+  tn = 0;
+
+  /* Every layer of neuron numbers has a halo of -1's, for neurons that don't exist. */
+
+  neuron_numbers.Setup(-e, tr + e, -e, tc + e, e_t);
+
+  /* Make all of the input neurons.
+     I'm creating them in column-major order rather than row-major, so the inputs are consecutive
+     starting at zero. (The internals are still row-major. */
+
+  for (j = 0; j < tc; j++) {
+    for (i = 0; i < tr; i++) {
+
+      net.Add_Node(tn);
+      if (j == 0) net.Add_Input(tn);
+      net.Set_Node_Property(tn, "Threshold", 1);
+      net.Set_Name(tn, "I[%d][%d]", i, j);
+      neuron_numbers.I(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* The C neurons.  Now, there is only one C neuron per row, and none in the top and bottom e rows. */
+
+  for (i = e; i < tr-e; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", mp-1);
+    net.Set_Name(tn, "C[%d][%d]", i, j);
+    neuron_numbers.C(i, j) = tn;
+    tn++;
+  }
+
+  /* There are 2e+1 columns of Core neurons, but only the first column and middle I_R of them are outputs.
+     For that reason, I'm going to create them in column major order. 
+     Plus -- the neurons in all columns but 0 have thresholds of 1, since they are
+     simply receiving spikes from their previous column. */
+
+  for (j = 0; j < tc; j++) {
+    for (i = e; i < tr-e; i++) {
+      net.Add_Node(tn);
+      net.Set_Node_Property(tn, "Threshold", (j == 0) ? 2 : 1);
+      net.Set_Name(tn, "Core[%d][%d]", i, j);
+      if (i >= 2*e && i < tr - 2*e && j == 0) net.Add_Output(tn);
+      neuron_numbers.Core(i, j) = tn;
+      tn++;
+    }
+  }
+
+  /* Make the B neurons - there is just one column of them, and they only exist for the middle I_R rows. */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Set_Node_Property(tn, "Threshold", 1);
+    net.Set_Name(tn, "B[%d][%d]", i, j);
+    neuron_numbers.B(i, j) = tn;
+    tn++;
+  }
+
+  /* Make the Border output neurons.  Also one column of these. */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    j = 0;
+    net.Add_Node(tn);
+    net.Add_Output(tn);
+    net.Set_Node_Property(tn, "Threshold", 2);
+    net.Set_Name(tn, "Border[%d][%d]", i, j);
+    neuron_numbers.Border(i, j) = tn;
+    tn++;
+  }
+
+  /* Add 2e+1 columns of Input memory neurons. They are parameterized by r, e and e_t.
+     Think of these neurons as columns of neurons of size r that persist prior ``frames''  
+     of input deeper into the network's execution. Allows for systolic to work temporally, too. */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (j = 0; j < tc; j++) {
+      for (i = 0; i < tr; i++) {
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_I%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_I[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+    /* Add 2e+1 columns of Core memory neurons.  They are parameterized by r, e, and e_t.
+     Think of these neurons as layers of size r*c that persist ``frames'' of core classifications deeper 
+     into the network's execution.
+  */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (j = 0; j < tc; j++) {
+      for (i = e; i < tr - e; i++) {
+        net.Add_Node(tn);
+        net.Set_Node_Property(tn, "Threshold", 1);
+        net.Set_Name(tn, "Mem_Core%d[%d][%d]", mem_layer, i, j); 
+        neuron_numbers.Mem_Core[mem_layer](i, j) = tn;
+        tn++;
+      }
+    }
+  }
+
+  /* Create the synapses from each I neuron to the next I neuron in the row. */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      to = neuron_numbers.I(i, j+1);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", 1);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_Core cols to successive Mem_Core cols and Mem_I cols
+    to successive Mem_I cols. This mirrors what is done with the I neurons above */
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) { 
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        to = neuron_numbers.Mem_Core[mem_layer](i, j+1);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        }
+
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        to = neuron_numbers.Mem_I[mem_layer](i, j+1);
+        if (to != -1) {
+          net.Add_Edge(from, to);
+          net.Set_Edge_Property(from, to, "Delay", 1);
+          net.Set_Edge_Property(from, to, "Weight", 1);
+        } 
+
+      }
+    }
+  }
+
+  /* Add synapses from all Mem_I layers to successive Mem_I layers. Do the same for
+     Mem_Core layers. There are e_t layers. This is wiring up the frames over time
+     so that earlier activity may feed back into the current frame.*/
+
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      j = 0; //First col (to which inputs are applied for I neurons)
+      delay = (int)ceil(R * 1.0 / I_R) * (C + (4 * e)); //I_C + (4 * e) + 4; 
+
+      if (mem_layer == 0) {
+        from = neuron_numbers.I(i, j);
+      } else {
+        from = neuron_numbers.Mem_I[mem_layer - 1](i, j);
+      }
+
+      to = neuron_numbers.Mem_I[mem_layer](i, j);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", delay);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      }     
+
+      // now for the Mem_Core neurons...
+      if (mem_layer == 0) {
+        from = neuron_numbers.Core(i, j);
+      } else {
+        from = neuron_numbers.Mem_Core[mem_layer - 1](i, j);
+      }
+
+      to = neuron_numbers.Mem_Core[mem_layer](i, j);
+      if (to != -1) {
+        net.Add_Edge(from, to);
+        net.Set_Edge_Property(from, to, "Delay", delay);
+        net.Set_Edge_Property(from, to, "Weight", 1);
+      } 
+
+    }
+  }
+
+  /* Create the synapses from each I neuron to the C neurons */
+
+  for (i = 0; i < tr; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.I(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != e) {
+          to = neuron_numbers.C(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from each Mem_I neuron to the C neurons */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = 0; i < tr; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_I[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          c = 0;
+          //if (r != 0 || j != 0) {
+            to = neuron_numbers.C(i+r, c);
+            if (to != -1) {
+              net.Add_Edge(from, to);
+              net.Set_Edge_Property(from, to, "Delay", 1);
+              net.Set_Edge_Property(from, to, "Weight", 1);
+            }
+          //}
+        }
+      }
+    }
+  }
+
+  /* Create the synapses from the center I's, and C neurons, to the output core. */
+
+  for (i = e; i < tr-e; i++) {
+    from = neuron_numbers.I(i, e);
+    to = neuron_numbers.Core(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 1 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.C(i, 0);
+    to = neuron_numbers.Core(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 2 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+
+  /* Create the synapses from each core to the next in line. */
+
+  for (i = e; i < tr-e; i++) {
+    for (j = 1; j < tc; j++) {
+      from = neuron_numbers.Core(i, j-1);
+      to = neuron_numbers.Core(i, j);
+      if (from == -1 || to == -1) {
+        fprintf(stderr, "Internal error 3 -- from (%d) or to (%d) = -1\n", from, to);
+        exit(1);
+      }
+      net.Add_Edge(from, to);
+      net.Set_Edge_Property(from, to, "Delay", 1);
+      net.Set_Edge_Property(from, to, "Weight", 1);
+    }
+  }
+
+  /* Now from the Cores to the B's. */
+
+  for (i = e; i < tr-e; i++) {
+    for (j = 0; j < tc; j++) {
+      from = neuron_numbers.Core(i, j);
+      for (r = -e; r <= e; r++) {
+        c = 0;
+        if (r != 0 || j != e) {
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+        }
+      }
+    }
+  }
+
+  /* Now from the Mem_Cores to the B's. */
+  for (mem_layer = 0; mem_layer < e_t; mem_layer++) {
+    for (i = e; i < tr - e; i++) {
+      for (j = 0; j < tc; j++) {
+        from = neuron_numbers.Mem_Core[mem_layer](i, j);
+        for (r = -e; r <= e; r++) {
+          c = 0;
+          //if (r != 0 || j != 0) { // Mem_Core to B neurons...prior event E_{r,c,t-x} *is in* current event E{r,c,t}'s neighborhood...
+          to = neuron_numbers.B(i+r, c);
+          if (to != -1) {
+            net.Add_Edge(from, to);
+            net.Set_Edge_Property(from, to, "Delay", 1);
+            net.Set_Edge_Property(from, to, "Weight", 1);
+          }
+          //}
+        }
+      }
+    }
+  }
+
+  /* Finally, from the B's, the center core and the right input to the border */
+
+  for (i = e*2; i < tr-e*2; i++) {
+    from = neuron_numbers.I(i, e*2);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 4 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+
+    /* Center input takes 2 to get to Core, but then e to get to Core[r][e], then
+       two more to get to the border. */
+
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 4);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+
+    from = neuron_numbers.Core(i, e);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 5 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 2);
+    net.Set_Edge_Property(from, to, "Weight", -1);
+
+    from = neuron_numbers.B(i, 0);
+    to = neuron_numbers.Border(i, 0);
+    if (from == -1 || to == -1) {
+      fprintf(stderr, "Internal error 6 -- from (%d) or to (%d) = -1\n", from, to);
+      exit(1);
+    }
+    net.Add_Edge(from, to);
+    net.Set_Edge_Property(from, to, "Delay", 1);
+    net.Set_Edge_Property(from, to, "Weight", 1);
+  }
+}
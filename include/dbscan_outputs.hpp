@@ -0,0 +1,484 @@
+/* Turning the output spikes of the dbscan networks into the grids of labeled events that the
+   output_xxx and 3d_output_xxx programs print.  Each program reads the processor_tool's OC or
+   OT output with DBSCAN_Read_Output(), and hands the output neurons to its function here.
+   bin/dbscan_pipeline gets the output neurons straight from the simulator, and calls the same
+   functions, so the two print exactly the same thing.
+
+   The output neurons are Core[r][c] and Border[r][c].  A DBSCAN_Output holds one of them:
+   its cell ('C' or 'B'), its row and column, and either its spike count (OC) or its spike
+   times (OT).  They have to be in the order that the network lists its outputs, because a
+   later output can overwrite an earlier one's label.
+
+   Long runs make a lot of output, so the decoding is one linear pass: the lines are parsed by
+   hand rather than with sscanf() and istringstream, and the 3D labels go into a dense
+   frames x R x C array of characters rather than nested maps of strings.
+
+   The STREAM networks can also be decoded as they run, with DBSCAN_Stream_Labels, which
+   takes the spikes in any order, and prints each frame as soon as its time is up.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+struct DBSCAN_Output {
+  char Cell;                   /* 'C' for Core, 'B' for Border */
+  int Node;
+  int Row, Col;
+  int Count;                   /* The spike count, or the number of spike times */
+  std::vector <int> Times;
+};
+
+/* Helpers for DBSCAN_Read_Output().  Each one advances s past what it matched.  A space in
+   DBSCAN_Scan_Text() matches any amount of white space, like in sscanf(). */
+
+inline void DBSCAN_Skip_Space(const char *&s)
+{
+  while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n') s++;
+}
+
+inline bool DBSCAN_Scan_Text(const char *&s, const char *text)
+{
+  for ( ; *text != '\0'; text++) {
+    if (*text == ' ') {
+      DBSCAN_Skip_Space(s);
+    } else if (*s == *text) {
+      s++;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool DBSCAN_Scan_Int(const char *&s, int &v)
+{
+  bool neg;
+
+  DBSCAN_Skip_Space(s);
+  neg = (*s == '-');
+  if (*s == '-' || *s == '+') s++;
+  if (*s < '0' || *s > '9') return false;
+  for (v = 0; *s >= '0' && *s <= '9'; s++) v = v * 10 + (*s - '0');
+  if (neg) v = -v;
+  return true;
+}
+
+/* A spike time, like "12.0", truncated to an int.  Anything with an exponent goes through
+   strtod(). */
+
+inline bool DBSCAN_Scan_Time(const char *&s, int &v)
+{
+  const char *start;
+  char *end;
+
+  DBSCAN_Skip_Space(s);
+  start = s;
+  if (!DBSCAN_Scan_Int(s, v)) return false;
+  if (*s == '.') {
+    for (s++; *s >= '0' && *s <= '9'; s++) ;
+  }
+  if (*s == 'e' || *s == 'E') {
+    v = strtod(start, &end);
+    s = end;
+  }
+  return true;
+}
+
+/* Parse a line of the processor_tool's OC or OT output.  Returns false if the line isn't
+   from a Core or Border neuron. */
+
+inline bool DBSCAN_Read_Output(const std::string &line, DBSCAN_Output &o)
+{
+  const char *s;
+  int time;
+
+  o.Times.clear();
+  s = line.c_str();
+  if (!DBSCAN_Scan_Text(s, "node") || !DBSCAN_Scan_Int(s, o.Node) || !DBSCAN_Scan_Text(s, "(")) return false;
+  if (DBSCAN_Scan_Text(s, "Border[")) {
+    o.Cell = 'B';
+  } else if (DBSCAN_Scan_Text(s, "Core[")) {
+    o.Cell = 'C';
+  } else {
+    return false;
+  }
+  if (!DBSCAN_Scan_Int(s, o.Row) || !DBSCAN_Scan_Text(s, "][") ||
+      !DBSCAN_Scan_Int(s, o.Col) || !DBSCAN_Scan_Text(s, "]) spike ")) return false;
+
+  if (DBSCAN_Scan_Text(s, "counts:")) return DBSCAN_Scan_Int(s, o.Count);
+  if (!DBSCAN_Scan_Text(s, "times:")) return false;
+  while (DBSCAN_Scan_Time(s, time)) o.Times.push_back(time);
+  o.Count = o.Times.size();
+  return true;
+}
+
+/* The 3D programs collect their labels in a DBSCAN_Frames, and print frames grids of R x C,
+   each followed by a blank line.  Anything that isn't labeled is a '.'.  Labels that are off
+   the grid are ignored. */
+
+class DBSCAN_Frames {
+  public:
+    DBSCAN_Frames(int frames, int rows, int cols)
+      : Frames(std::max(frames, 0)), Rows(std::max(rows, 0)), Cols(std::max(cols, 0)),
+        Labels((size_t) Frames * Rows * Cols, '.') {}
+
+    void Set(int f, int r, int c, char cell) {
+      if (f >= 0 && f < Frames && r >= 0 && r < Rows && c >= 0 && c < Cols) {
+        Labels[((size_t) f * Rows + r) * Cols + c] = cell;
+      }
+    }
+
+    void Print() const;
+
+  protected:
+    int Frames, Rows, Cols;
+    std::vector <char> Labels;
+};
+
+/* Print a frame at a time, with one fwrite(). */
+
+inline void DBSCAN_Frames::Print() const
+{
+  std::string buf;
+  int f, r;
+
+  buf.reserve((size_t) Rows * (Cols + 1) + 1);
+  for (f = 0; f < Frames; f++) {
+    buf.clear();
+    for (r = 0; r < Rows; r++) {
+      buf.append(Labels.data() + ((size_t) f * Rows + r) * Cols, Cols);
+      buf.push_back('\n');
+    }
+    buf.push_back('\n');
+    fwrite(buf.data(), 1, buf.size(), stdout);
+  }
+}
+
+/* bin/output_flat: the flat networks, with spike counts, full or partial. */
+
+inline void DBSCAN_Output_Flat(const std::vector <DBSCAN_Output> &outs)
+{
+  std::map < int, std::map < int, std::string > > pts;
+  std::map < int, std::map < int, std::string > >::iterator pit;
+  std::map < int, std::string >::iterator iit;
+  std::string cell;
+  size_t i;
+
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    cell = o.Cell;
+    if (pts[o.Row][o.Col] == "") {
+      pts[o.Row][o.Col] = (o.Count == 0) ? "." : cell;
+    } else if (o.Count != 0) {
+      pts[o.Row][o.Col] = cell;
+    }
+  }
+
+  for (pit = pts.begin(); pit != pts.end(); pit++) {
+    for (iit = pit->second.begin(); iit != pit->second.end(); iit++) {
+      printf("%s", iit->second.c_str());
+    }
+    printf("\n");
+  }
+}
+
+/* bin/output_systolic_full and bin/output_systolic_partial: the systolic networks, with
+   spike times.  A row's column c is labeled when its neuron spikes at time c + sc, where sc
+   is the delay through the network.  cols is C for full, and I_C for partial. */
+
+inline void DBSCAN_Output_Systolic(const std::vector <DBSCAN_Output> &outs, int cols,
+                                   int core_sc, int border_sc)
+{
+  std::map < int, std::string > pts;
+  std::map < int, std::string >::iterator pit;
+  size_t i, j;
+  int c, sc;
+
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    if (o.Cell == 'B') {
+      sc = border_sc;
+    } else {
+      sc = core_sc;
+      pts[o.Row].resize(cols, '.');
+    }
+    for (j = 0; j < o.Times.size(); j++) {
+      c = o.Times[j] - sc;
+      if (c >= 0 && c < cols) pts[o.Row][c] = o.Cell;
+    }
+  }
+
+  for (pit = pts.begin(); pit != pts.end(); pit++) {
+    printf("%s\n", pit->second.c_str());
+  }
+}
+
+inline void DBSCAN_Output_Systolic_Full(const std::vector <DBSCAN_Output> &outs, int e, int C)
+{
+  DBSCAN_Output_Systolic(outs, C, e + 2, e*2 + 4);
+}
+
+inline void DBSCAN_Output_Systolic_Partial(const std::vector <DBSCAN_Output> &outs, int e, int I_C)
+{
+  DBSCAN_Output_Systolic(outs, I_C, e*3 + 2, e*4 + 4);
+}
+
+/* bin/3d_output_flat_full: frame f's labels come out at time f+2 (Core) and f+4 (Border). */
+
+inline void DBSCAN_Output_3D_Flat_Full(const std::vector <DBSCAN_Output> &outs, int R, int C, int frames)
+{
+  DBSCAN_Frames pts(frames, R, C);
+  size_t i, j;
+
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    for (j = 0; j < o.Times.size(); j++) {
+      pts.Set(o.Times[j] - ((o.Cell == 'B') ? 4 : 2), o.Row, o.Col, o.Cell);
+    }
+  }
+  pts.Print();
+}
+
+/* bin/3d_output_flat_partial: the same, but the network has 2e rows and columns of padding. */
+
+inline void DBSCAN_Output_3D_Flat_Partial(const std::vector <DBSCAN_Output> &outs, int I_R, int I_C,
+                                          int e, int frames)
+{
+  DBSCAN_Frames pts(frames, I_R, I_C);
+  size_t i, j;
+
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    for (j = 0; j < o.Times.size(); j++) {
+      pts.Set(o.Times[j] - ((o.Cell == 'B') ? 4 : 2), o.Row - 2 * e, o.Col - 2 * e, o.Cell);
+    }
+  }
+  pts.Print();
+}
+
+/* bin/3d_output_systolic_full and bin/3d_output_systolic_partial: each frame takes frame_rt
+   timesteps, and within a frame, it's like the 2D systolic networks. */
+
+inline void DBSCAN_Output_3D_Systolic_Full(const std::vector <DBSCAN_Output> &outs, int e, int R, int C,
+                                           int frames)
+{
+  DBSCAN_Frames pts(frames, R, C);
+  size_t i, j;
+  int frame_rt, sc, t;
+
+  frame_rt = C + 2 * e + 4;
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    sc = (o.Cell == 'B') ? e*2 + 4 : e + 2;
+    for (j = 0; j < o.Times.size(); j++) {
+      t = o.Times[j];
+      pts.Set(t / frame_rt, o.Row, t % frame_rt - sc, o.Cell);
+    }
+  }
+  pts.Print();
+}
+
+inline void DBSCAN_Output_3D_Systolic_Partial(const std::vector <DBSCAN_Output> &outs, int I_R, int I_C,
+                                              int e, int frames)
+{
+  DBSCAN_Frames pts(frames, I_R, I_C);
+  size_t i, j;
+  int frame_rt, sc, t;
+
+  frame_rt = I_C + 4 * e + 4;
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    sc = (o.Cell == 'B') ? e*4 + 4 : e*3 + 2;
+    for (j = 0; j < o.Times.size(); j++) {
+      t = o.Times[j];
+      pts.Set(t / frame_rt, o.Row - 2 * e, t % frame_rt - sc, o.Cell);
+    }
+  }
+  pts.Print();
+}
+
+/* The STREAM networks sweep each frame in pieces, one after another, so a spike's time says
+   which frame, and which piece of it, its label is for:
+
+     3D_FLAT_STREAM       Each timestep is one I_R x I_C piece of a frame, in row-major
+                          order, so a frame takes strides_per_frame timesteps.  Core spikes
+                          come 2 timesteps after their piece, and Border spikes 4.
+     3D_SYSTOLIC_STREAM   The network sweeps each band of I_R rows across all C columns (plus
+                          4e of padding), one band after another, so a frame takes frame_rt
+                          timesteps.  Core spikes come 3e+2 timesteps after their column,
+                          and Border spikes 4e+4.
+
+   Where() does that arithmetic.  The batch functions below use it to label all of the
+   frames at once.  For streaming, Add() takes spikes in any order, and Flush(time) says that
+   every spike before time has been added.  Frame f is done when the last timestep of its
+   window, plus the Border latency, is before time, so Flush() prints it then, and forgets
+   it.  Only the frames that aren't done are kept.
+
+   Since the spikes don't come in the order of the outputs, each label remembers the
+   priority of the output that set it.  A later output overwrites a label only if its
+   priority is at least as high, just like the batch functions, which go through the outputs
+   in order.  The priority is the output's index, or its node id -- the networks are sorted,
+   so the two are in the same order. */
+
+class DBSCAN_Stream_Labels {
+  public:
+    void Flat(int R, int C, int I_R, int I_C, int e);
+    void Systolic(int R, int C, int I_R, int e);
+
+    void Where(char cell, int row, int col, int time, int &f, int &r, int &c) const;
+    void Add(char cell, int row, int col, int time, int priority);
+    void Flush(int time, int frames);         /* Print the done frames, up to frames */
+    void Finish(int frames);                  /* Print the rest of them */
+
+  protected:
+    bool Is_Flat = true;
+    int Rows = 0, Cols = 0, IR = 0, IC = 0, E = 0;
+    int Frame_Time = 1;                       /* strides_per_frame, or frame_rt */
+    int Latency = 0;                          /* Of the Border spikes */
+    int Pieces_Per_Row = 1, Bands = 1;
+    int First = 0;                            /* The first frame that hasn't been printed */
+    std::deque < std::vector <char> > Labels; /* Frames First, First+1, ... */
+    std::deque < std::vector <int> > Priority;
+
+    void Print_First();
+};
+
+inline void DBSCAN_Stream_Labels::Flat(int R, int C, int I_R, int I_C, int e)
+{
+  Is_Flat = true;
+  Rows = R;
+  Cols = C;
+  IR = I_R;
+  IC = I_C;
+  E = e;
+  Pieces_Per_Row = ceil(C * 1.0 / I_C);
+  Frame_Time = ceil(R * 1.0 / I_R) * Pieces_Per_Row;
+  Latency = 4;
+}
+
+inline void DBSCAN_Stream_Labels::Systolic(int R, int C, int I_R, int e)
+{
+  Is_Flat = false;
+  Rows = R;
+  Cols = C;
+  IR = I_R;
+  E = e;
+  Bands = ceil(R * 1.0 / I_R);
+  Frame_Time = Bands * (C + 4 * e);
+  Latency = 4 * e + 4;
+}
+
+inline void DBSCAN_Stream_Labels::Where(char cell, int row, int col, int time, int &f, int &r, int &c) const
+{
+  int t, w;
+
+  if (Is_Flat) {
+    t = time - ((cell == 'B') ? 4 : 2);
+    f = t / Frame_Time;
+    r = (t % Frame_Time) / Pieces_Per_Row * IR + row - 2 * E;
+    c = (t % Frame_Time) % Pieces_Per_Row * IC + col - 2 * E;
+  } else {
+    w = Cols + 4 * E;
+    t = time - ((cell == 'B') ? 4 * E + 4 : 3 * E + 2);
+    f = t / Frame_Time;
+    r = ((t / w) % Bands) * IR + row - 2 * E;
+    c = t % w;
+  }
+}
+
+inline void DBSCAN_Stream_Labels::Add(char cell, int row, int col, int time, int priority)
+{
+  int f, r, c;
+  size_t i;
+
+  Where(cell, row, col, time, f, r, c);
+  if (f < First || r < 0 || r >= Rows || c < 0 || c >= Cols) return;
+  while ((int) Labels.size() <= f - First) {
+    Labels.push_back(std::vector <char> ((size_t) Rows * Cols, '.'));
+    Priority.push_back(std::vector <int> ((size_t) Rows * Cols, -1));
+  }
+  i = (size_t) r * Cols + c;
+  if (priority >= Priority[f - First][i]) {
+    Labels[f - First][i] = cell;
+    Priority[f - First][i] = priority;
+  }
+}
+
+/* Print frame First, and flush it, so that whoever is reading gets it right away. */
+
+inline void DBSCAN_Stream_Labels::Print_First()
+{
+  std::string buf;
+  int r;
+
+  if (Labels.empty()) {
+    Labels.push_back(std::vector <char> ((size_t) Rows * Cols, '.'));
+    Priority.push_back(std::vector <int> ());
+  }
+  for (r = 0; r < Rows; r++) {
+    buf.append(Labels[0].data() + (size_t) r * Cols, Cols);
+    buf.push_back('\n');
+  }
+  buf.push_back('\n');
+  fwrite(buf.data(), 1, buf.size(), stdout);
+  fflush(stdout);
+  Labels.pop_front();
+  Priority.pop_front();
+  First++;
+}
+
+inline void DBSCAN_Stream_Labels::Flush(int time, int frames)
+{
+  while (First < frames && (long long) (First + 1) * Frame_Time + Latency <= time) Print_First();
+}
+
+inline void DBSCAN_Stream_Labels::Finish(int frames)
+{
+  while (First < frames) Print_First();
+}
+
+/* bin/3d_output_flat_partial_stream and bin/3d_output_systolic_partial_stream, all at once. */
+
+inline void DBSCAN_Output_3D_Stream(const std::vector <DBSCAN_Output> &outs, const DBSCAN_Stream_Labels &sl,
+                                    int R, int C, int frames)
+{
+  DBSCAN_Frames pts(frames, R, C);
+  size_t i, j;
+  int f, r, c;
+
+  for (i = 0; i < outs.size(); i++) {
+    const DBSCAN_Output &o = outs[i];
+    for (j = 0; j < o.Times.size(); j++) {
+      sl.Where(o.Cell, o.Row, o.Col, o.Times[j], f, r, c);
+      pts.Set(f, r, c, o.Cell);
+    }
+  }
+  pts.Print();
+}
+
+inline void DBSCAN_Output_3D_Flat_Partial_Stream(const std::vector <DBSCAN_Output> &outs, int R, int C,
+                                                 int I_R, int I_C, int e, int frames)
+{
+  DBSCAN_Stream_Labels sl;
+
+  sl.Flat(R, C, I_R, I_C, e);
+  DBSCAN_Output_3D_Stream(outs, sl, R, C, frames);
+}
+
+inline void DBSCAN_Output_3D_Systolic_Partial_Stream(const std::vector <DBSCAN_Output> &outs, int R, int C,
+                                                     int I_R, int e, int frames)
+{
+  DBSCAN_Stream_Labels sl;
+
+  sl.Systolic(R, C, I_R, e);
+  DBSCAN_Output_3D_Stream(outs, sl, R, C, frames);
+}
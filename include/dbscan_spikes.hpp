@@ -0,0 +1,297 @@
+/* Turning frames of events into input spikes for the dbscan networks, as bin/create_spikes_full
+   and bin/create_spikes_partial do.  bin/dbscan_pipeline makes the same spikes, and applies
+   them straight to the simulator.
+
+   The frames are lines of '0' and '1', with a blank line after each frame, or the binary
+   frames of include/frame_file.hpp, which Next_Frame() recognizes by the first character.  A
+   DBSCAN_Spike_Encoder reads them one frame at a time, and makes each frame's spikes as soon
+   as it has read it, so it only ever holds one frame.  Each input neuron gets the '1's of
+   its piece of the frame, at these times (W is the width of the piece, including padding):
+
+     FLAT, SYSTOLIC, SYSTOLIC_AS    Frame 0 only: time 0 for FLAT, and column c at time c
+                                    for the systolic ones.  The other frames are ignored.
+     3D_FLAT                        Frame f at time f.
+     3D_SYSTOLIC(_AS)               Frame f at time f*(W+gap), and column c at c after that.
+                                    gap is 2e+4 for full, 4 for partial 3D_SYSTOLIC, and 0
+                                    for partial 3D_SYSTOLIC_AS.
+     3D_FLAT_STREAM                 The frame is cut into ceil(R/I_R)*ceil(C/I_C) pieces,
+                                    in row-major order, and each one gets its own timestep.
+     3D_SYSTOLIC_STREAM(_AS)        The frame is cut into ceil(R/I_R) bands of all of the
+                                    columns, and each one takes W timesteps.
+
+   The partial pieces have 2e of padding on each side, and the piece (or the first piece, in
+   the STREAM modes) starts at row sr-2e and column sc-2e.  Padding that is off the frame is
+   zeros.
+
+   Spikes() gives a frame's spikes as "AS" commands, with times from the start of the run,
+   in the same order as the programs have always printed them.  SYSTOLIC, 3D_SYSTOLIC and
+   3D_SYSTOLIC_STREAM print "ASR" rasters instead, which span all of the frames, so for
+   those, the programs collect each frame's part of the rasters with Rasters() and print
+   them at the end.
+
+   The rasters are mostly zeros, and their length is the whole run, so SYSTOLIC_AST,
+   3D_SYSTOLIC_AST and 3D_SYSTOLIC_STREAM_AST make the same spikes as the raster modes, but
+   print them as "AST node time time ...", one line per input neuron per frame, with only the
+   times of the '1's.  That's as big as the number of events, not the number of timesteps,
+   and it can be printed a frame at a time.  Only bin/snn_sim reads AST -- the processor_tool
+   doesn't.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include "frame_file.hpp"
+
+struct DBSCAN_Spike {
+  int Node;
+  int Time;
+};
+
+class DBSCAN_Spike_Encoder {
+  public:
+    void Full(const std::string &mode, int e);
+    void Partial(const std::string &mode, int ir, int ic, int sr, int sc, int e);
+
+    bool Next_Frame(std::istream &in);                      /* Read and check the next frame */
+    void Spikes(std::vector <DBSCAN_Spike> &spikes) const;  /* Append its spikes */
+    void Rasters(std::vector <std::string> &rasters) const; /* Append its part of the rasters */
+    bool Uses_Rasters() const;                              /* Does the mode print ASR? */
+    bool Uses_Times() const { return Is_Times; }            /* Does the mode print AST? */
+    int Frame_Start(int frame) const;                       /* No spike of frame is earlier */
+
+    int Frame = -1;                                         /* The current frame */
+    int Rows = 0, Cols = 0;                                 /* The size of frame 0 */
+
+  protected:
+    std::string Mode;
+    bool Is_Partial = false;
+    bool Is_3D = false, Is_Flat = false, Is_Stream = false;
+    bool Is_Times = false;                                  /* A raster mode with _AST */
+    int IR = 0, IC = 0, SR = 0, SC = 0, E = 0;
+    int Pad = 0;                                            /* Padding on each side of a piece */
+    int Gap = 0;                                            /* Zeros after each systolic piece */
+    int Piece_Rows = 0, Piece_Cols = 0, Pieces = 0;         /* Pieces is per frame */
+    int Piece_Time = 0;                                     /* Timesteps per piece */
+    std::vector <std::string> Lines;                        /* The current frame */
+    Frame_File_Reader File;                                 /* If the frames are binary */
+
+    void Set_Mode(const std::string &mode);
+    void Piece(int p, int &r0, int &c0, int &start) const;
+    char At(int r, int c) const { return (r >= 0 && r < (int) Lines.size() &&
+                                          c >= 0 && c < (int) Lines[r].size()) ? Lines[r][c] : '0'; }
+};
+
+/* ------------------------------------------------------------ */
+
+inline void DBSCAN_Spike_Encoder::Set_Mode(const std::string &mode)
+{
+  Is_Times = (mode.size() > 4 && mode.substr(mode.size() - 4) == "_AST");
+  Mode = (Is_Times) ? mode.substr(0, mode.size() - 4) : mode;
+  Is_3D = (mode.substr(0, 3) == "3D_");
+  Is_Flat = (mode == "FLAT" || mode == "3D_FLAT" || mode == "3D_FLAT_STREAM");
+  Is_Stream = (mode.find("STREAM") != std::string::npos);
+}
+
+inline void DBSCAN_Spike_Encoder::Full(const std::string &mode, int e)
+{
+  Set_Mode(mode);
+  Is_Partial = false;
+  E = e;
+  Pad = 0;
+  Gap = 2 * e + 4;
+}
+
+inline void DBSCAN_Spike_Encoder::Partial(const std::string &mode, int ir, int ic, int sr, int sc, int e)
+{
+  if (ir < 1 || ic < 1) { fprintf(stderr, "I_R and I_C have to be > 0\n"); exit(1); }
+  Set_Mode(mode);
+  Is_Partial = true;
+  IR = ir;
+  IC = ic;
+  SR = sr;
+  SC = sc;
+  E = e;
+  Pad = 2 * e;
+  Gap = (Mode == "3D_SYSTOLIC") ? 4 : 0;
+}
+
+inline bool DBSCAN_Spike_Encoder::Uses_Rasters() const
+{
+  return (!Is_Times && (Mode == "SYSTOLIC" || Mode == "3D_SYSTOLIC" || Mode == "3D_SYSTOLIC_STREAM"));
+}
+
+/* Read lines up to a blank line or the end of the input.  The size of frame 0 sets the size
+   of the pieces.  Only a character that isn't '0' or '1' is fatal. */
+
+inline bool DBSCAN_Spike_Encoder::Next_Frame(std::istream &in)
+{
+  std::string l;
+  int j, k;
+
+  if (Frame == -1) File.Open(in);
+  if (File.Rows > 0) {
+    if (!File.Next()) return false;
+    File.Lines(Lines);
+  } else {
+    Lines.clear();
+    if (!getline(in, l)) return false;
+    while (l != "") {
+      Lines.push_back(l);
+      if (!getline(in, l)) break;
+    }
+    if (Frame == -1 && Lines.size() == 0) return false;
+  }
+  Frame++;
+
+  if (Frame == 0) {
+    Rows = Lines.size();
+    Cols = Lines[0].size();
+    if (!Is_Partial) {
+      Piece_Rows = Rows;
+      Piece_Cols = Cols;
+      Pieces = 1;
+    } else {
+      if (SR >= Rows) { fprintf(stderr, "sr too big\n"); exit(1); }
+      if (SC >= Cols) { fprintf(stderr, "sc too big\n"); exit(1); }
+      if (Is_Stream && !Is_Flat) IC = Cols;     /* The systolic bands are all of the columns */
+      Piece_Rows = IR + 2 * Pad;
+      Piece_Cols = IC + 2 * Pad;
+      Pieces = (Is_Stream) ? ((Rows + IR - 1) / IR) * ((Cols + IC - 1) / IC) : 1;
+    }
+    Piece_Time = (Is_Flat) ? 1 : Piece_Cols + ((Is_3D) ? Gap : 0);
+  }
+
+  for (j = 0; j < (int) Lines.size(); j++) {
+    for (k = 0; k < (int) Lines[j].size(); k++) {
+      if (Lines[j][k] != '0' && Lines[j][k] != '1') {
+        fprintf(stderr, "Non-zero/one character at frame %d row %d col %d\n", Frame, j, k);
+        exit(1);
+      }
+    }
+    if ((int) Lines[j].size() != Cols) {
+      fprintf(stderr, "Error -- frame %d: lines %d and %d are different sizes\n", Frame, j, 0);
+    }
+  }
+  if ((int) Lines.size() != Rows) {
+    fprintf(stderr, "Error -- Frames %d and %d are different sizes\n", 0, Frame);
+  }
+  return true;
+}
+
+/* Where piece p of the current frame starts in the frame, and when it starts. */
+
+inline void DBSCAN_Spike_Encoder::Piece(int p, int &r0, int &c0, int &start) const
+{
+  int per_row;
+
+  if (!Is_Partial) {
+    r0 = 0;
+    c0 = 0;
+  } else {
+    per_row = (Cols + IC - 1) / IC;
+    r0 = SR - Pad + ((Is_Stream) ? (p / per_row) * IR : 0);
+    c0 = SC - Pad + ((Is_Stream) ? (p % per_row) * IC : 0);
+  }
+  start = (Is_3D) ? (Frame * Pieces + p) * Piece_Time : 0;
+}
+
+inline int DBSCAN_Spike_Encoder::Frame_Start(int frame) const
+{
+  return (Is_3D) ? frame * Pieces * Piece_Time : 0;
+}
+
+inline void DBSCAN_Spike_Encoder::Spikes(std::vector <DBSCAN_Spike> &spikes) const
+{
+  DBSCAN_Spike s;
+  int p, r0, c0, start, j, k;
+
+  if (!Is_3D && Frame > 0) return;
+
+  for (p = 0; p < Pieces; p++) {
+    Piece(p, r0, c0, start);
+    if (Is_Flat) {                              /* A neuron per cell, in row-major order */
+      for (j = 0; j < Piece_Rows; j++) {
+        for (k = 0; k < Piece_Cols; k++) {
+          if (At(r0 + j, c0 + k) == '1') {
+            s.Node = j * Piece_Cols + k;
+            s.Time = start;
+            spikes.push_back(s);
+          }
+        }
+      }
+    } else if (!Is_3D) {                        /* A neuron per row, row by row */
+      for (j = 0; j < Piece_Rows; j++) {
+        for (k = 0; k < Piece_Cols; k++) {
+          if (At(r0 + j, c0 + k) == '1') {
+            s.Node = j;
+            s.Time = k;
+            spikes.push_back(s);
+          }
+        }
+      }
+    } else {                                    /* A neuron per row, in time order */
+      for (k = 0; k < Piece_Cols; k++) {
+        for (j = 0; j < Piece_Rows; j++) {
+          if (At(r0 + j, c0 + k) == '1') {
+            s.Node = j;
+            s.Time = start + k;
+            spikes.push_back(s);
+          }
+        }
+      }
+    }
+  }
+}
+
+inline void DBSCAN_Spike_Encoder::Rasters(std::vector <std::string> &rasters) const
+{
+  int p, r0, c0, start, j, k;
+
+  if (!Is_3D && Frame > 0) return;
+
+  if ((int) rasters.size() < Piece_Rows) rasters.resize(Piece_Rows);
+  for (p = 0; p < Pieces; p++) {
+    Piece(p, r0, c0, start);
+    for (j = 0; j < Piece_Rows; j++) {
+      for (k = 0; k < Piece_Cols; k++) rasters[j].push_back(At(r0 + j, c0 + k));
+      if (Is_3D) rasters[j].append(Gap, '0');
+    }
+  }
+}
+
+/* Print a frame's spikes, as AS or AST commands, and at the end, the rasters. */
+
+inline void DBSCAN_Print_Spikes(const std::vector <DBSCAN_Spike> &spikes)
+{
+  size_t i;
+
+  for (i = 0; i < spikes.size(); i++) printf("AS %d %d 1\n", spikes[i].Node, spikes[i].Time);
+}
+
+inline void DBSCAN_Print_Spike_Times(const std::vector <DBSCAN_Spike> &spikes)
+{
+  std::vector <DBSCAN_Spike> s;
+  size_t i;
+
+  s = spikes;
+  std::stable_sort(s.begin(), s.end(),
+                   [](const DBSCAN_Spike &a, const DBSCAN_Spike &b) { return a.Node < b.Node; });
+  for (i = 0; i < s.size(); i++) {
+    if (i == 0 || s[i].Node != s[i-1].Node) printf("%sAST %d", (i == 0) ? "" : "\n", s[i].Node);
+    printf(" %d", s[i].Time);
+  }
+  if (s.size() > 0) printf("\n");
+}
+
+inline void DBSCAN_Print_Rasters(const std::vector <std::string> &rasters)
+{
+  size_t i;
+
+  for (i = 0; i < rasters.size(); i++) printf("ASR %d %s\n", (int) i, rasters[i].c_str());
+}
@@ -0,0 +1,224 @@
+/* 3D DBSCAN on the events themselves, rather than on frames.  It takes (t, x, y, polarity)
+   events in time order, from a sensor or from include/event_file.hpp, and labels each one
+   Core, Border or Noise, with the same definitions as libdbscan, except that the time axis is
+   microseconds rather than frames:
+
+   - An event's window is every event whose x and y are within epsilon of its own, and whose
+     time is between t-epsilon_t and t.  It includes the event itself.  Like libdbscan, the
+     window only reaches back, so an event's label never waits on later events.
+   - An event is Core if its window has at least min_points events.
+   - An event that isn't Core is Border if there's a Core event in its window, and Noise
+     otherwise.
+
+   Events with the same time are in each other's windows, so they are labeled together: Add()
+   holds an event until an event with a later time shows up (or Flush() is called), and then
+   labels everything at the earlier time.  That's the only latency -- one tick of the clock.
+
+   The state is kept per pixel, for R*C pixels (twice that with polarity, where ON events only
+   see ON events and OFF events only see OFF events):
+
+   - Last: the time of the pixel's last event -- the last-event-time surface.
+   - Times: a ring of the times of the pixel's last min_points events, newest first.  This is
+     the spatial index of the recent events.  More than min_points events at one pixel can't
+     change whether a window has min_points events, so the older ones are dropped.
+   - Last_Core: the time of the pixel's last Core event.
+
+   Counting a window visits (2e+1)^2 pixels of Last, which are a few cache lines, and only
+   looks at the rings of the pixels that are recent enough.  It stops a ring at its first event
+   that's too old, and stops altogether at min_points.  The Border test visits the same pixels
+   of Last_Core.  So the work per event is bounded by 2(2e+1)^2 + min_points, no matter how
+   busy the sensor is, and nothing is allocated once the pending events have grown to the most
+   at one time.  Events must be in time order (AEDAT4 and DV's csv files are).  Errors are
+   fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+
+struct Event_DBSCAN_Event {
+  long long T;                         /* Microseconds */
+  short X, Y;
+  signed char Polarity;
+  char Label;                          /* 'C', 'B' or '.', like libdbscan */
+};
+
+class Event_DBSCAN {
+  public:
+    Event_DBSCAN(int rows, int cols, int epsilon, long long epsilon_t, int min_points,
+                 bool polarity = false);
+
+    bool Add(long long t, short x, short y, signed char polarity);  /* True if Labeled is new */
+    bool Flush();                                                   /* Label what's pending */
+
+    std::vector <Event_DBSCAN_Event> Labeled;   /* The events at the last time labeled */
+
+  protected:
+    int Rows, Cols, E, Min_Points;
+    long long Et;
+    bool Polarity;
+    std::vector <int64_t> Last;                 /* The last event's time per pixel */
+    std::vector <int64_t> Times;                /* Rings of Min_Points times per pixel */
+    std::vector <uint32_t> Head;                /* The newest entry of each ring */
+    std::vector <int64_t> Last_Core;
+    std::vector <Event_DBSCAN_Event> Pending;   /* The events at the current time */
+
+    size_t Pixel(const Event_DBSCAN_Event &ev) const;
+    bool Is_Core(const Event_DBSCAN_Event &ev) const;
+    bool Is_Border(const Event_DBSCAN_Event &ev) const;
+    void Label();
+};
+
+/* ------------------------------------------------------------ */
+
+inline Event_DBSCAN::Event_DBSCAN(int rows, int cols, int epsilon, long long epsilon_t,
+                                  int min_points, bool polarity)
+{
+  size_t pixels;
+
+  if (rows < 1 || cols < 1) { fprintf(stderr, "Event_DBSCAN: bad size %dx%d\n", rows, cols); exit(1); }
+  if (epsilon < 0) { fprintf(stderr, "Event_DBSCAN: epsilon must be >= 0\n"); exit(1); }
+  if (epsilon_t < 0) { fprintf(stderr, "Event_DBSCAN: epsilon_t must be >= 0\n"); exit(1); }
+  if (min_points < 1) { fprintf(stderr, "Event_DBSCAN: min_points must be >= 1\n"); exit(1); }
+
+  Rows = rows;
+  Cols = cols;
+  E = epsilon;
+  Et = epsilon_t;
+  Min_Points = min_points;
+  Polarity = polarity;
+  pixels = (size_t) rows * cols * ((polarity) ? 2 : 1);
+  Last.assign(pixels, INT64_MIN);
+  Times.assign(pixels * min_points, INT64_MIN);
+  Head.assign(pixels, 0);
+  Last_Core.assign(pixels, INT64_MIN);
+}
+
+/* With polarity, the OFF pixels come after the ON pixels. */
+
+inline size_t Event_DBSCAN::Pixel(const Event_DBSCAN_Event &ev) const
+{
+  size_t p;
+
+  p = (size_t) ev.Y * Cols + ev.X;
+  if (Polarity && ev.Polarity <= 0) p += (size_t) Rows * Cols;
+  return p;
+}
+
+inline bool Event_DBSCAN::Add(long long t, short x, short y, signed char polarity)
+{
+  Event_DBSCAN_Event ev;
+  bool labeled;
+  size_t p;
+
+  if (x < 0 || x >= Cols) { fprintf(stderr, "Bad value for x (column value): %d.\n0 <= x < %d\n", x, Cols); exit(1); }
+  if (y < 0 || y >= Rows) { fprintf(stderr, "Bad value for y (row value): %d.\n0 <= y < %d\n", y, Rows); exit(1); }
+
+  labeled = false;
+  if (Pending.size() > 0 && t != Pending[0].T) {
+    if (t < Pending[0].T) {
+      fprintf(stderr, "Event_DBSCAN: an event at time %lld comes after one at %lld.  The events must be in time order.\n",
+              t, Pending[0].T);
+      exit(1);
+    }
+    labeled = Flush();
+  }
+
+  /* The event goes into its pixel's ring now, so the other events at this time see it. */
+
+  ev.T = t;
+  ev.X = x;
+  ev.Y = y;
+  ev.Polarity = polarity;
+  ev.Label = '.';
+  p = Pixel(ev);
+  Head[p] = (Head[p] + 1 == (uint32_t) Min_Points) ? 0 : Head[p] + 1;
+  Times[p * Min_Points + Head[p]] = t;
+  Last[p] = t;
+  Pending.push_back(ev);
+  return labeled;
+}
+
+inline bool Event_DBSCAN::Flush()
+{
+  if (Pending.size() == 0) return false;
+  Label();
+  Labeled.swap(Pending);
+  Pending.clear();
+  return true;
+}
+
+inline bool Event_DBSCAN::Is_Core(const Event_DBSCAN_Event &ev) const
+{
+  int r, c, r0, r1, c0, c1, count;
+  uint32_t h, j;
+  size_t base, p;
+  const int64_t *ring;
+  long long oldest;
+
+  oldest = ev.T - Et;
+  r0 = (ev.Y - E < 0) ? 0 : ev.Y - E;
+  r1 = (ev.Y + E >= Rows) ? Rows - 1 : ev.Y + E;
+  c0 = (ev.X - E < 0) ? 0 : ev.X - E;
+  c1 = (ev.X + E >= Cols) ? Cols - 1 : ev.X + E;
+  base = (Polarity && ev.Polarity <= 0) ? (size_t) Rows * Cols : 0;
+  count = 0;
+
+  for (r = r0; r <= r1; r++) {
+    for (c = c0; c <= c1; c++) {
+      p = base + (size_t) r * Cols + c;
+      if (Last[p] < oldest) continue;
+      ring = Times.data() + p * Min_Points;
+      h = Head[p];
+      for (j = 0; j < (uint32_t) Min_Points && ring[h] >= oldest; j++) {
+        if (++count >= Min_Points) return true;
+        h = (h == 0) ? Min_Points - 1 : h - 1;
+      }
+    }
+  }
+  return false;
+}
+
+inline bool Event_DBSCAN::Is_Border(const Event_DBSCAN_Event &ev) const
+{
+  int r, c, r0, r1, c0, c1;
+  size_t base;
+  long long oldest;
+
+  oldest = ev.T - Et;
+  r0 = (ev.Y - E < 0) ? 0 : ev.Y - E;
+  r1 = (ev.Y + E >= Rows) ? Rows - 1 : ev.Y + E;
+  c0 = (ev.X - E < 0) ? 0 : ev.X - E;
+  c1 = (ev.X + E >= Cols) ? Cols - 1 : ev.X + E;
+  base = (Polarity && ev.Polarity <= 0) ? (size_t) Rows * Cols : 0;
+
+  for (r = r0; r <= r1; r++) {
+    for (c = c0; c <= c1; c++) {
+      if (Last_Core[base + (size_t) r * Cols + c] >= oldest) return true;
+    }
+  }
+  return false;
+}
+
+/* Every pending event is in the rings already.  The Core events go into Last_Core before
+   any Border test, so that Core events at this time make Borders at this time. */
+
+inline void Event_DBSCAN::Label()
+{
+  size_t i;
+
+  for (i = 0; i < Pending.size(); i++) {
+    if (Is_Core(Pending[i])) Pending[i].Label = 'C';
+  }
+  for (i = 0; i < Pending.size(); i++) {
+    if (Pending[i].Label == 'C') Last_Core[Pixel(Pending[i])] = Pending[i].T;
+  }
+  for (i = 0; i < Pending.size(); i++) {
+    if (Pending[i].Label != 'C' && Is_Border(Pending[i])) Pending[i].Label = 'B';
+  }
+}
@@ -0,0 +1,267 @@
+/* Reading a file of event-camera events, for bin/ebc_to_frames and bin/event_dbscan.  The
+   file is either a csv file of time,x,y,polarity lines, or an AEDAT4 recording (see
+   include/aedat4.hpp).
+
+   Read_Event_File() calls sink.Add(time, x, y, polarity) on every event, in file order, and
+   that's all that it does with the sink.  Polarity is 1 or 0 for AEDAT4, and whatever the csv
+   file says for csv.
+
+   A regular csv file is mmap'd and cut into chunks at line boundaries, which a pool of threads
+   parses with a hand-written integer parser.  The chunks are handed to the sink in file order,
+   as they finish, in the thread that called Read_Event_File(), so the sink doesn't need to be
+   thread-safe, and only a few chunks' events are ever in memory.  Files that can't be mmap'd
+   (pipes) are read a line at a time with sscanf().  Errors are fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "aedat4.hpp"
+
+/* The mmap'd csv file.  Chunk k starts just after the first newline at or after byte
+   k*Chunk_Size-1, so each worker can find its chunk's boundaries without the others.
+   Workers take chunks in order, and can get at most Slots.size() chunks ahead of the sink,
+   which runs in the calling thread. */
+
+struct CSV_Event {
+  long long time;
+  short x, y;
+  signed char polarity;
+};
+
+struct CSV_Chunk {
+  size_t Number = (size_t) -1;          /* The chunk in this slot */
+  bool Done = false;
+  std::vector <CSV_Event> Events;
+  const char *Bad = NULL;               /* The first line that didn't parse, if any */
+};
+
+class CSV_Reader {
+  public:
+    const char *Buf;
+    size_t Size;
+    size_t Chunk_Size = 4 << 20;
+
+    template <class Sink> void Run(Sink &sink, int threads);
+
+  protected:
+    size_t Chunks, Next = 0, Binned = 0;
+    std::vector <CSV_Chunk> Slots;
+    std::mutex Lock;
+    std::condition_variable Changed;
+
+    size_t Start(size_t k) const;
+    void Parse(size_t k, CSV_Chunk &chunk) const;
+    template <class Sink> void Bin(CSV_Chunk &chunk, Sink &sink) const;
+    void Worker();
+};
+
+template <class Sink> void Read_Event_File(const std::string &file, Sink &sink, int threads);
+
+/* ------------------------------------------------------------ */
+
+inline size_t CSV_Reader::Start(size_t k) const
+{
+  const char *nl;
+
+  if (k == 0) return 0;
+  if (k * Chunk_Size >= Size) return Size;
+  nl = (const char *) memchr(Buf + k * Chunk_Size - 1, '\n', Size - (k * Chunk_Size - 1));
+  return (nl == NULL) ? Size : nl - Buf + 1;
+}
+
+/* This accepts what sscanf("%lld,%hd,%hd,%hhd") does: whitespace and a sign before each
+   number, no space before the commas, and anything after the polarity. */
+
+static inline bool CSV_Parse_Number(const char *&p, const char *e, long long &v)
+{
+  bool neg;
+  const char *d;
+  unsigned long long u;
+
+  while (p < e && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) p++;
+  neg = (p < e && *p == '-');
+  if (p < e && (*p == '-' || *p == '+')) p++;
+  d = p;
+  u = 0;
+  while (p < e && (unsigned) (*p - '0') < 10) u = u * 10 + (*p++ - '0');
+  v = (neg) ? -u : u;
+  return (p != d);
+}
+
+inline void CSV_Reader::Parse(size_t k, CSV_Chunk &chunk) const
+{
+  const char *p, *e, *end, *line;
+  long long v[4];
+  CSV_Event ev;
+  int i;
+
+  chunk.Events.clear();
+  chunk.Bad = NULL;
+  p = Buf + Start(k);
+  end = Buf + Start(k + 1);
+  while (p < end) {
+    line = p;
+    e = (const char *) memchr(p, '\n', end - p);
+    if (e == NULL) e = end;
+    for (i = 0; i < 4; i++) {
+      if (i > 0) {
+        if (p >= e || *p != ',') break;
+        p++;
+      }
+      if (!CSV_Parse_Number(p, e, v[i])) break;
+    }
+    if (i < 4) {
+      chunk.Bad = line;
+      return;
+    }
+    ev.time = v[0];
+    ev.x = v[1];
+    ev.y = v[2];
+    ev.polarity = v[3];
+    chunk.Events.push_back(ev);
+    p = e + 1;
+  }
+}
+
+template <class Sink> void CSV_Reader::Bin(CSV_Chunk &chunk, Sink &sink) const
+{
+  size_t i;
+  const char *e;
+
+  for (i = 0; i < chunk.Events.size(); i++) {
+    sink.Add(chunk.Events[i].time, chunk.Events[i].x, chunk.Events[i].y, chunk.Events[i].polarity);
+  }
+  if (chunk.Bad != NULL) {
+    e = (const char *) memchr(chunk.Bad, '\n', Buf + Size - chunk.Bad);
+    if (e == NULL) e = Buf + Size;
+    fprintf(stderr,"Trouble parsing line: %s\n\nExpected format is: time,x,y,polarity\n",
+            std::string(chunk.Bad, e).c_str());
+    exit(1);
+  }
+}
+
+inline void CSV_Reader::Worker()
+{
+  size_t k;
+
+  while (true) {
+    std::unique_lock <std::mutex> l(Lock);
+    if (Next >= Chunks) return;
+    k = Next++;
+    Changed.wait(l, [&] { return k < Binned + Slots.size(); });
+    CSV_Chunk &chunk = Slots[k % Slots.size()];
+    l.unlock();
+
+    Parse(k, chunk);
+
+    l.lock();
+    chunk.Number = k;
+    chunk.Done = true;
+    Changed.notify_all();
+  }
+}
+
+template <class Sink> void CSV_Reader::Run(Sink &sink, int threads)
+{
+  std::vector <std::thread> workers;
+  size_t k;
+  int i;
+
+  Chunks = (Size + Chunk_Size - 1) / Chunk_Size;
+  if (threads == 1) {
+    Slots.resize(1);
+    for (k = 0; k < Chunks; k++) {
+      Parse(k, Slots[0]);
+      Bin(Slots[0], sink);
+    }
+    return;
+  }
+
+  Slots.resize(2 * threads);
+  for (i = 0; i < threads; i++) workers.push_back(std::thread(&CSV_Reader::Worker, this));
+  for (k = 0; k < Chunks; k++) {
+    std::unique_lock <std::mutex> l(Lock);
+    CSV_Chunk &chunk = Slots[k % Slots.size()];
+    Changed.wait(l, [&] { return chunk.Done && chunk.Number == k; });
+    l.unlock();
+
+    Bin(chunk, sink);
+
+    l.lock();
+    chunk.Done = false;
+    Binned++;
+    Changed.notify_all();
+  }
+  for (i = 0; i < threads; i++) workers[i].join();
+}
+
+/* ------------------------------------------------------------ */
+
+template <class Sink> void Read_Event_File(const std::string &file, Sink &sink, int threads)
+{
+  std::string line;
+  std::ifstream fin;
+  short x, y;
+  long long time;
+  signed char polarity;
+  int fd;
+  size_t i;
+  struct stat st;
+  void *buf;
+  AEDAT4_Reader aedat;
+  CSV_Reader csv;
+  std::vector <AEDAT4_Event> events;
+
+  if (AEDAT4_Is_File(file)) {
+    aedat.Open(file);
+    while (aedat.Next_Packet(events)) {
+      for (i = 0; i < events.size(); i++) {
+        sink.Add(events[i].T, events[i].X, events[i].Y, (events[i].On) ? 1 : 0);
+      }
+    }
+    return;
+  }
+
+  /* A regular file is mmap'd and parsed in parallel. */
+
+  fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) { perror(file.c_str()); exit(1); }
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    if (st.st_size > 0) {
+      buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (buf == MAP_FAILED) { perror(file.c_str()); exit(1); }
+      madvise(buf, st.st_size, MADV_SEQUENTIAL);
+      csv.Buf = (const char *) buf;
+      csv.Size = st.st_size;
+      csv.Run(sink, threads);
+      munmap(buf, st.st_size);
+    }
+    close(fd);
+    return;
+  }
+  close(fd);
+
+  fin.open(file);
+  if (fin.fail()) { perror(file.c_str()); exit(1); }
+  while (getline(fin, line)) {
+    if (sscanf(line.c_str(), "%lld,%hd,%hd,%hhd", &time, &x, &y, &polarity) != 4) {
+      fprintf(stderr,"Trouble parsing line: %s\n\nExpected format is: time,x,y,polarity\n",line.c_str());
+      exit(1);
+    }
+    sink.Add(time, x, y, polarity);
+  }
+}
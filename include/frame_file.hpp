@@ -0,0 +1,307 @@
+/* A binary file of event frames, for bin/ebc_to_frames -b.  The text frames (a line of '0'
+   and '1' per row, and a blank line after each frame) are R*C+R+1 bytes per frame no matter
+   how few events there are, which is a lot of '0's at 1280x720 and 1 ms bins.  This format is
+   as big as the number of events, and you can seek to any frame with two reads.
+
+   Everything is little-endian:
+
+   - A 40-byte header: "DBFRAMES", int32 R, int32 C, int64 bin width (microseconds), int64
+     number of frames, and int64 file position of the index.  The last two are -1 if the
+     writer couldn't seek back to fill them in (e.g. it was writing to a pipe).
+   - The frames.  Each is a uint32 n, the number of cells that are on, and then either n
+     uint32 cell numbers (row*C+col), in increasing order, or a bitmap of (R*C+7)/8 bytes, in
+     which cell i is bit i%8 of byte i/8.  It's the list if it's no bigger than the bitmap
+     (4n <= (R*C+7)/8), so the frames are never bigger than their bitmaps.
+   - With polarity (bin/ebc_to_frames -b -p), the magic number is "DBFRAME2", and each frame
+     is two of those: the cells that had an ON event, and then the cells that had an OFF event.
+     A cell can be in both.
+   - A uint32 0xffffffff, which ends the frames.
+   - The index: the int64 file position of each frame.
+   - A 16-byte trailer: int64 number of frames and int64 position of the index, so that a
+     file whose header wasn't filled in can still seek.
+
+   Frame_File_Writer writes to a FILE *, a frame at a time, so it holds nothing but the index.
+   Frame_File_Reader reads from an istream, a frame at a time.  Open() peeks at the first
+   character, and returns false without reading anything if it's not this format, so the
+   programs that read frames can take either one.  Seek() needs a stream that can seek.
+   Cells is every cell with an event, so the programs that don't care about polarity read a
+   file with polarity just like one without.  On and Off have the two channels.  Errors are
+   fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <sys/types.h>
+#include <fcntl.h>
+
+#define FRAME_FILE_MAGIC "DBFRAMES"
+#define FRAME_FILE_MAGIC_2 "DBFRAME2"
+#define FRAME_FILE_END 0xffffffffU
+
+class Frame_File_Writer {
+  public:
+    void Open(FILE *f, int rows, int cols, long long bin_width, int channels = 1);
+    void Write(const std::vector <uint32_t> &cells);   /* Increasing cell numbers */
+    void Write(const std::vector <uint32_t> &on,       /* With two channels */
+               const std::vector <uint32_t> &off);
+    void Close();                                      /* Doesn't close the FILE */
+
+  protected:
+    FILE *F = NULL;
+    int64_t Header[3];                                 /* Bin width, frames, index */
+    int32_t Rows = 0, Cols = 0;
+    int Channels = 1;
+    int64_t Pos = 0;                                   /* Bytes written */
+    bool Seekable = false;                             /* Can we go back to the header? */
+    std::vector <int64_t> Index;
+    std::vector <unsigned char> Bitmap;
+
+    void Put(const void *buf, size_t n);
+    void Put_Cells(const std::vector <uint32_t> &cells);
+};
+
+class Frame_File_Reader {
+  public:
+    bool Open(std::istream &in);                       /* False if it's not a frame file */
+    bool Next();                                       /* Read the next frame into Cells */
+    bool Seek(long long frame);                        /* So that Next() reads frame */
+    void Lines(std::vector <std::string> &lines) const;/* Cells, as '0'/'1' lines */
+
+    int Rows = 0, Cols = 0;
+    int Channels = 0;                                  /* 1, or 2 with polarity */
+    long long Bin_Width = 0;
+    long long Frames = -1;                             /* -1 if we don't know yet */
+    long long Frame = -1;                              /* The frame in Cells */
+    std::vector <uint32_t> Cells;                      /* Increasing cell numbers */
+    std::vector <uint32_t> On, Off;                    /* The channels, if there are two */
+
+  protected:
+    std::istream *In = NULL;
+    long long Index = -1;
+    std::vector <unsigned char> Bitmap;
+
+    void Get(void *buf, size_t n);
+    void Get_Cells(uint32_t n, std::vector <uint32_t> &cells);
+    bool Find_Index();
+};
+
+/* ------------------------------------------------------------ */
+
+inline void Frame_File_Writer::Put(const void *buf, size_t n)
+{
+  if (fwrite(buf, 1, n, F) != n) { perror("Frame_File_Writer"); exit(1); }
+  Pos += n;
+}
+
+inline void Frame_File_Writer::Open(FILE *f, int rows, int cols, long long bin_width, int channels)
+{
+  F = f;
+  Channels = channels;
+  Seekable = (ftello(f) == 0 && !(fcntl(fileno(f), F_GETFL) & O_APPEND));
+  Rows = rows;
+  Cols = cols;
+  Pos = 0;
+  Index.clear();
+  Header[0] = bin_width;
+  Header[1] = -1;
+  Header[2] = -1;
+  Put((Channels == 2) ? FRAME_FILE_MAGIC_2 : FRAME_FILE_MAGIC, 8);
+  Put(&Rows, 4);
+  Put(&Cols, 4);
+  Put(Header, 24);
+}
+
+inline void Frame_File_Writer::Write(const std::vector <uint32_t> &cells)
+{
+  Index.push_back(Pos);
+  Put_Cells(cells);
+}
+
+inline void Frame_File_Writer::Write(const std::vector <uint32_t> &on, const std::vector <uint32_t> &off)
+{
+  Index.push_back(Pos);
+  Put_Cells(on);
+  Put_Cells(off);
+}
+
+inline void Frame_File_Writer::Put_Cells(const std::vector <uint32_t> &cells)
+{
+  uint32_t n;
+  size_t bytes, i;
+
+  n = cells.size();
+  bytes = ((size_t) Rows * Cols + 7) / 8;
+  Put(&n, 4);
+  if ((size_t) n * 4 <= bytes) {
+    if (n > 0) Put(cells.data(), (size_t) n * 4);
+  } else {
+    Bitmap.assign(bytes, 0);
+    for (i = 0; i < cells.size(); i++) Bitmap[cells[i] >> 3] |= (1 << (cells[i] & 7));
+    Put(Bitmap.data(), bytes);
+  }
+}
+
+/* Write the end, the index and the trailer, and then fill in the header if we can. */
+
+inline void Frame_File_Writer::Close()
+{
+  uint32_t end;
+
+  end = FRAME_FILE_END;
+  Put(&end, 4);
+  Header[1] = Index.size();
+  Header[2] = Pos;
+  if (Index.size() > 0) Put(Index.data(), Index.size() * 8);
+  Put(&Header[1], 16);
+  fflush(F);
+  if (Seekable && fseeko(F, 24, SEEK_SET) == 0) {
+    Put(&Header[1], 16);
+    fseeko(F, 0, SEEK_END);
+  }
+  fflush(F);
+}
+
+/* ------------------------------------------------------------ */
+
+inline void Frame_File_Reader::Get(void *buf, size_t n)
+{
+  In->read((char *) buf, n);
+  if ((size_t) In->gcount() != n) {
+    fprintf(stderr, "Frame file: it ends in the middle of frame %lld\n", Frame + 1);
+    exit(1);
+  }
+}
+
+inline bool Frame_File_Reader::Open(std::istream &in)
+{
+  char magic[8];
+  int32_t rc[2];
+  int64_t h[3];
+
+  In = &in;
+  if (in.peek() != FRAME_FILE_MAGIC[0]) return false;
+  Get(magic, 8);
+  if (memcmp(magic, FRAME_FILE_MAGIC, 8) == 0) {
+    Channels = 1;
+  } else if (memcmp(magic, FRAME_FILE_MAGIC_2, 8) == 0) {
+    Channels = 2;
+  } else {
+    fprintf(stderr, "Frame file: bad magic number\n");
+    exit(1);
+  }
+  Get(rc, 8);
+  Get(h, 24);
+  Rows = rc[0];
+  Cols = rc[1];
+  Bin_Width = h[0];
+  Frames = h[1];
+  Index = h[2];
+  Frame = -1;
+  if (Rows < 1 || Cols < 1) { fprintf(stderr, "Frame file: bad size %dx%d\n", Rows, Cols); exit(1); }
+  return true;
+}
+
+inline bool Frame_File_Reader::Next()
+{
+  uint32_t n;
+
+  Cells.clear();
+  if (In->peek() == EOF) return false;                   /* The writer didn't finish */
+  Get(&n, 4);
+  if (n == FRAME_FILE_END) {
+    if (Frames < 0) Frames = Frame + 1;
+    return false;
+  }
+  Frame++;
+
+  if (Channels == 1) {
+    Get_Cells(n, Cells);
+  } else {
+    Get_Cells(n, On);
+    Get(&n, 4);
+    Get_Cells(n, Off);
+    Cells.resize(On.size() + Off.size());
+    Cells.resize(std::set_union(On.begin(), On.end(), Off.begin(), Off.end(), Cells.begin()) - Cells.begin());
+  }
+  return true;
+}
+
+inline void Frame_File_Reader::Get_Cells(uint32_t n, std::vector <uint32_t> &c)
+{
+  uint32_t i, j;
+  size_t bytes, cells;
+
+  c.clear();
+  cells = (size_t) Rows * Cols;
+  bytes = (cells + 7) / 8;
+  if ((size_t) n * 4 <= bytes) {
+    c.resize(n);
+    if (n > 0) Get(c.data(), (size_t) n * 4);
+    for (i = 0; i < n; i++) {
+      if (c[i] >= cells || (i > 0 && c[i] <= c[i-1])) {
+        fprintf(stderr, "Frame file: bad cell number %u in frame %lld\n", c[i], Frame);
+        exit(1);
+      }
+    }
+  } else {
+    Bitmap.resize(bytes);
+    Get(Bitmap.data(), bytes);
+    for (i = 0; i < bytes; i++) {
+      for (j = 0; Bitmap[i] != 0 && j < 8; j++) {
+        if (Bitmap[i] & (1 << j)) c.push_back(i * 8 + j);
+      }
+    }
+    if (c.size() != n || (c.size() > 0 && c.back() >= cells)) {
+      fprintf(stderr, "Frame file: frame %lld's bitmap doesn't match its count\n", Frame);
+      exit(1);
+    }
+  }
+}
+
+/* If the header doesn't have the index, the trailer does. */
+
+inline bool Frame_File_Reader::Find_Index()
+{
+  int64_t t[2];
+
+  if (Index >= 0) return true;
+  In->clear();
+  In->seekg(-16, std::ios::end);
+  if (In->fail()) { In->clear(); return false; }
+  Get(t, 16);
+  Frames = t[0];
+  Index = t[1];
+  return (Index >= 0);
+}
+
+inline bool Frame_File_Reader::Seek(long long frame)
+{
+  int64_t pos;
+
+  if (!Find_Index() || frame < 0 || frame >= Frames) return false;
+  In->clear();
+  In->seekg(Index + frame * 8);
+  if (In->fail()) { In->clear(); return false; }
+  Get(&pos, 8);
+  In->seekg(pos);
+  if (In->fail()) { In->clear(); return false; }
+  Frame = frame - 1;
+  return true;
+}
+
+inline void Frame_File_Reader::Lines(std::vector <std::string> &lines) const
+{
+  size_t i;
+
+  lines.assign(Rows, std::string(Cols, '0'));
+  for (i = 0; i < Cells.size(); i++) lines[Cells[i] / Cols][Cells[i] % Cols] = '1';
+}
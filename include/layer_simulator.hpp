@@ -0,0 +1,478 @@
+/* A simulator for networks that are built out of layers, like the flat DBSCAN networks.
+   It runs a whole layer at a time, and never walks individual synapses.
+
+   In the flat constructions, every neuron is named X[r][c], and all of the X neurons
+   have the same threshold.  The synapses from the X layer to the Y layer with a given delay
+   and weight form a stencil: if there's a synapse from X[r][c] to Y[r+dr][c+dc], then
+   there's one from every X neuron to the Y neuron at the same offset, whenever that Y
+   neuron exists.  For example, I -> C is the (2e+1)x(2e+1) box without its center, and
+   I -> Core is the single offset (0,0).
+
+   Try_Load() finds the layers from the names, collects the offsets of each stencil, and
+   then counts the synapses to make sure that the network really is every stencil applied to
+   every neuron.  If it isn't, Try_Load() says why and returns false, and you should use
+   SNN_Simulator instead.  Mem_I0[r][c] is layer "Mem_I0".  The rows and columns of all
+   layers are in the same coordinates, and a layer doesn't have to be a rectangle: neurons
+   that don't exist just never fire.
+
+   Each layer keeps the last max_delay timesteps of its spikes as byte planes (one byte per
+   neuron, 0 or 1), in a ring.  A timestep computes each layer's charge, as int16's, by
+   adding each of its stencils applied to the source layer's plane from delay timesteps
+   ago.  A box stencil is a running sum down the rows, followed by one shifted add per
+   column of the box.  A stencil that's a box without one offset is the box minus that
+   offset, and anything else is one shifted add per offset.  All of these are loops over
+   contiguous rows, which the compiler vectorizes.  Then each layer fires where its charge
+   reaches its threshold.  Planes with no spikes are skipped, and when nothing has fired for
+   max_delay timesteps, Run() jumps to the next input spike.
+
+   The results are identical to SNN_Simulator's.  The inputs, outputs and proc_params work
+   the same way, and the cost is proportional to the number of neurons per timestep, rather
+   than the number of spikes.  That makes it faster on dense inputs and slower on sparse
+   ones.  Errors are fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include "snn_network.hpp"
+#include "snn_simulator.hpp"
+
+class Layer_Simulator : public SNN_Simulator {
+  public:
+    void Load(const SNN_Network &net);                            /* Fatal if not layered */
+    bool Try_Load(const SNN_Network &net, std::string &why);
+
+    void Run(int duration);
+    void Clear_Activity();
+
+    int Num_Layers() const { return Layers.size(); }
+
+  protected:
+    struct Layer {
+      std::string Name;
+      int Threshold;
+      std::vector <uint8_t> Exists;                      /* H*W */
+      std::vector <int> Output;                          /* H*W output indices, or empty */
+      std::vector < std::vector <uint8_t> > Planes;      /* The ring of spikes */
+      std::vector <int64_t> Plane_Time;                  /* The time of each plane */
+      std::vector <int16_t> Charge;                      /* H*W */
+      bool Charged;                                      /* Does Charge have anything this timestep? */
+    };
+
+    /* Stencil kinds */
+
+    enum { BOX, BOX_MINUS_ONE, OFFSETS };
+
+    struct Stencil {
+      int From, To, Delay, Weight;
+      std::vector < std::pair <int, int> > Offsets;      /* (dr, dc) */
+      int Kind;
+      int Dr0, Dr1, Dc0, Dc1;                            /* The bounding box of the offsets */
+      int Missing_Dr, Missing_Dc;                        /* For BOX_MINUS_ONE */
+    };
+
+    bool Not_Layered(std::string &why, const char *fmt, ...) __attribute__ ((format (printf, 3, 4)));
+    void Box(const uint8_t *f, const Stencil &s, int16_t *charge);
+    void Shifted_Add(const uint8_t *f, int dr, int dc, int w, int16_t *charge);
+
+    int H = 0, W = 0;                                    /* The grid that holds every layer */
+    std::vector <Layer> Layers;
+    std::vector <Stencil> Stencils;
+    std::vector <int> Node_Layer, Node_Cell;             /* cell = r*W + c, in the grid */
+    std::vector <int32_t> Column_Sum;                    /* Scratch for Box() */
+    int Max_Delay = 1;
+    int64_t Last_Spike = 0;                              /* The last time that anything fired */
+};
+
+/* ------------------------------------------------------------ */
+
+inline bool Layer_Simulator::Not_Layered(std::string &why, const char *fmt, ...)
+{
+  va_list ap;
+  char buf[1000];
+
+  va_start(ap, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  why = buf;
+  return false;
+}
+
+inline void Layer_Simulator::Load(const SNN_Network &net)
+{
+  std::string why;
+
+  if (!Try_Load(net, why)) Fatal("the network isn't layered -- %s", why.c_str());
+}
+
+inline bool Layer_Simulator::Try_Load(const SNN_Network &net, std::string &why)
+{
+  std::map <std::string, int> layer_ids;
+  std::map <std::string, int>::iterator lit;
+  std::map < std::vector <int>, int > stencil_ids;
+  std::map < std::vector <int>, int >::iterator sit;
+  std::vector <int> key, rows, cols, count, targets;
+  std::string prefix;
+  const char *name;
+  char *end;
+  uint64_t i, e;
+  int r, c, rmin, rmax, cmin, cmax, l, to, dr, dc, cell, k, area, m, j;
+  int64_t fan_in;
+  float f;
+  Stencil *s;
+
+  Read_Params(net.Empty_Network);
+
+  /* Every neuron has to be named Prefix[r][c]. */
+
+  Layers.clear();
+  Node_Layer.resize(net.Nodes);
+  rows.resize(net.Nodes);
+  cols.resize(net.Nodes);
+  rmin = cmin = 0x7fffffff;
+  rmax = cmax = -0x7fffffff;
+  for (i = 0; i < net.Nodes; i++) {
+    name = net.Name(i);
+    end = (char *) strchr(name, '[');
+    if (end == NULL || end == name || sscanf(end, "[%d][%d]", &r, &c) != 2) {
+      return Not_Layered(why, "node %llu's name (%s) isn't Layer[r][c]", (unsigned long long) i, name);
+    }
+    prefix.assign(name, end - name);
+    f = net.Threshold[i];
+    if (f != floorf(f)) return Not_Layered(why, "node %llu's threshold isn't an integer", (unsigned long long) i);
+    lit = layer_ids.find(prefix);
+    if (lit == layer_ids.end()) {
+      layer_ids[prefix] = Layers.size();
+      Layers.resize(Layers.size() + 1);
+      Layers.back().Name = prefix;
+      Layers.back().Threshold = f;
+      lit = layer_ids.find(prefix);
+    }
+    l = lit->second;
+    if (f != Layers[l].Threshold) {
+      return Not_Layered(why, "the %s neurons don't all have the same threshold", prefix.c_str());
+    }
+    Node_Layer[i] = l;
+    rows[i] = r;
+    cols[i] = c;
+    rmin = std::min(rmin, r);
+    rmax = std::max(rmax, r);
+    cmin = std::min(cmin, c);
+    cmax = std::max(cmax, c);
+  }
+  if (net.Nodes == 0) return Not_Layered(why, "the network is empty");
+
+  H = rmax - rmin + 1;
+  W = cmax - cmin + 1;
+  if ((int64_t) H * W > 0x7fffffff / 2) return Not_Layered(why, "the grid is too big");
+
+  /* Thresholds, as in SNN_Simulator.  A neuron that gets no charge can't fire in either
+     simulator, so the thresholds have to be more than zero and the minimum potential. */
+
+  for (l = 0; l < (int) Layers.size(); l++) {
+    if (!Threshold_Inclusive) Layers[l].Threshold++;
+    if (Layers[l].Threshold <= std::max(0, (int) Min_Potential)) {
+      return Not_Layered(why, "the %s threshold has to be more than 0 and min_potential",
+                         Layers[l].Name.c_str());
+    }
+    Layers[l].Exists.assign(H * W, 0);
+  }
+
+  Node_Cell.resize(net.Nodes);
+  for (i = 0; i < net.Nodes; i++) {
+    cell = (rows[i] - rmin) * W + (cols[i] - cmin);
+    if (Layers[Node_Layer[i]].Exists[cell]) {
+      return Not_Layered(why, "two neurons are named %s", net.Name(i));
+    }
+    Layers[Node_Layer[i]].Exists[cell] = 1;
+    Node_Cell[i] = cell;
+  }
+
+  /* Group the synapses into stencils by (from layer, to layer, delay, weight), and collect
+     their offsets.  A neuron can't have two synapses to the same neuron. */
+
+  Stencils.clear();
+  count.clear();
+  Max_Delay = 1;
+  key.resize(4);
+  for (i = 0; i < net.Nodes; i++) {
+    targets.clear();
+    for (e = net.Edge_Start[i]; e < net.Edge_Start[i+1]; e++) {
+      to = net.Synapses[e].To;
+      targets.push_back(to);
+      f = net.Synapses[e].Weight;
+      if (f != floorf(f) || f < -32767 || f > 32767) return Not_Layered(why, "the weights have to be small integers");
+      if (net.Synapses[e].Delay < 1) return Not_Layered(why, "the delays have to be >= 1");
+      key[0] = Node_Layer[i];
+      key[1] = Node_Layer[to];
+      key[2] = net.Synapses[e].Delay;
+      key[3] = f;
+      sit = stencil_ids.find(key);
+      if (sit == stencil_ids.end()) {
+        stencil_ids[key] = Stencils.size();
+        Stencils.resize(Stencils.size() + 1);
+        count.push_back(0);
+        s = &Stencils.back();
+        s->From = key[0];
+        s->To = key[1];
+        s->Delay = key[2];
+        s->Weight = key[3];
+        Max_Delay = std::max(Max_Delay, s->Delay);
+        sit = stencil_ids.find(key);
+      }
+      s = &Stencils[sit->second];
+      s->Offsets.push_back(std::make_pair(rows[to] - rows[i], cols[to] - cols[i]));
+      count[sit->second]++;
+    }
+    std::sort(targets.begin(), targets.end());
+    for (j = 1; j < (int) targets.size(); j++) {
+      if (targets[j] == targets[j-1]) return Not_Layered(why, "node %llu has two synapses to node %d", (unsigned long long) i, targets[j]);
+    }
+  }
+
+  /* Now make sure that each stencil is complete: the number of synapses has to be the
+     number of (from neuron, offset) pairs whose to neuron exists. */
+
+  for (k = 0; k < (int) Stencils.size(); k++) {
+    s = &Stencils[k];
+    std::sort(s->Offsets.begin(), s->Offsets.end());
+    s->Offsets.erase(std::unique(s->Offsets.begin(), s->Offsets.end()), s->Offsets.end());
+    fan_in = 0;
+    for (r = 0; r < H; r++) {
+      for (c = 0; c < W; c++) {
+        if (!Layers[s->From].Exists[r*W+c]) continue;
+        for (j = 0; j < (int) s->Offsets.size(); j++) {
+          dr = r + s->Offsets[j].first;
+          dc = c + s->Offsets[j].second;
+          if (dr >= 0 && dr < H && dc >= 0 && dc < W && Layers[s->To].Exists[dr*W+dc]) fan_in++;
+        }
+      }
+    }
+    if (fan_in != count[k]) {
+      return Not_Layered(why, "the synapses from %s to %s (delay %d, weight %d) aren't the same for every neuron",
+                         Layers[s->From].Name.c_str(), Layers[s->To].Name.c_str(), s->Delay, s->Weight);
+    }
+
+    /* What kind of stencil is it? */
+
+    s->Dr0 = s->Dr1 = s->Offsets[0].first;
+    s->Dc0 = s->Dc1 = s->Offsets[0].second;
+    for (j = 0; j < (int) s->Offsets.size(); j++) {
+      s->Dr0 = std::min(s->Dr0, s->Offsets[j].first);
+      s->Dr1 = std::max(s->Dr1, s->Offsets[j].first);
+      s->Dc0 = std::min(s->Dc0, s->Offsets[j].second);
+      s->Dc1 = std::max(s->Dc1, s->Offsets[j].second);
+    }
+    area = (s->Dr1 - s->Dr0 + 1) * (s->Dc1 - s->Dc0 + 1);
+    m = s->Offsets.size();
+    if (m > 1 && m == area) {
+      s->Kind = BOX;
+    } else if (m > 2 && m == area - 1) {
+      s->Kind = BOX_MINUS_ONE;
+      s->Missing_Dr = s->Dr0;
+      s->Missing_Dc = s->Dc0;
+      for (j = 0; j < m && s->Offsets[j] == std::make_pair(s->Missing_Dr, s->Missing_Dc); j++) {
+        s->Missing_Dc++;
+        if (s->Missing_Dc > s->Dc1) { s->Missing_Dc = s->Dc0; s->Missing_Dr++; }
+      }
+    } else {
+      s->Kind = OFFSETS;
+    }
+  }
+
+  /* The charge has to fit into an int16. */
+
+  for (l = 0; l < (int) Layers.size(); l++) {
+    fan_in = 0;
+    for (k = 0; k < (int) Stencils.size(); k++) {
+      if (Stencils[k].To == l) fan_in += (int64_t) abs(Stencils[k].Weight) * Stencils[k].Offsets.size();
+    }
+    if (fan_in > 16000) return Not_Layered(why, "the %s neurons get too much charge for int16", Layers[l].Name.c_str());
+  }
+
+  /* The inputs have to be small, too, but that's checked in Run(). */
+
+  Load_IO(net);
+  for (i = 0; i < net.Num_Outputs; i++) {
+    l = Node_Layer[Outputs[i]];
+    if (Layers[l].Output.empty()) Layers[l].Output.assign(H * W, -1);
+    Layers[l].Output[Node_Cell[Outputs[i]]] = i;
+  }
+  for (l = 0; l < (int) Layers.size(); l++) {
+    Layers[l].Planes.assign(Max_Delay + 1, std::vector <uint8_t> (H * W, 0));
+    Layers[l].Plane_Time.assign(Max_Delay + 1, -1);
+    Layers[l].Charge.assign(H * W, 0);
+    Layers[l].Charged = false;
+  }
+  Column_Sum.resize(W);
+  Clear_Activity();
+  return true;
+}
+
+inline void Layer_Simulator::Clear_Activity()
+{
+  size_t l;
+
+  for (l = 0; l < Layers.size(); l++) {
+    std::fill(Layers[l].Plane_Time.begin(), Layers[l].Plane_Time.end(), -1);
+  }
+  Last_Spike = Now - Max_Delay - 1;
+  Pending.clear();
+}
+
+/* charge[r][c] += weight * (the sum of f over rows r-Dr1..r-Dr0 and columns c-Dc1..c-Dc0).
+   Column_Sum is the sum down the rows, which slides by adding one row and subtracting
+   another. */
+
+inline void Layer_Simulator::Box(const uint8_t *f, const Stencil &s, int16_t *charge)
+{
+  int r, c, a, dc, lo, hi;
+  int32_t *cs;
+  int16_t *ch;
+  const uint8_t *row;
+
+  cs = Column_Sum.data();
+  std::fill(Column_Sum.begin(), Column_Sum.end(), 0);
+  for (a = std::max(0, -s.Dr1); a < std::min(H, -s.Dr0); a++) {
+    row = f + a * W;
+    for (c = 0; c < W; c++) cs[c] += row[c];
+  }
+
+  for (r = 0; r < H; r++) {
+    a = r - s.Dr0;
+    if (a >= 0 && a < H) {
+      row = f + a * W;
+      for (c = 0; c < W; c++) cs[c] += row[c];
+    }
+    a = r - s.Dr1 - 1;
+    if (a >= 0 && a < H) {
+      row = f + a * W;
+      for (c = 0; c < W; c++) cs[c] -= row[c];
+    }
+    ch = charge + r * W;
+    for (dc = s.Dc0; dc <= s.Dc1; dc++) {
+      lo = std::max(0, dc);
+      hi = std::min(W, W + dc);
+      for (c = lo; c < hi; c++) ch[c] += s.Weight * cs[c - dc];
+    }
+  }
+}
+
+/* charge[r][c] += w * f[r-dr][c-dc] */
+
+inline void Layer_Simulator::Shifted_Add(const uint8_t *f, int dr, int dc, int w, int16_t *charge)
+{
+  int r, c, lo, hi;
+  int16_t *ch;
+  const uint8_t *row;
+
+  lo = std::max(0, dc);
+  hi = std::min(W, W + dc);
+  for (r = std::max(0, dr); r < std::min(H, H + dr); r++) {
+    row = f + (r - dr) * W;
+    ch = charge + r * W;
+    for (c = lo; c < hi; c++) ch[c] += w * row[c - dc];
+  }
+}
+
+inline void Layer_Simulator::Run(int duration)
+{
+  int64_t t, end;
+  size_t i, p, k, j;
+  int slot, c, n, v;
+  bool any;
+  Layer *L, *F;
+  const Stencil *s;
+  const uint8_t *f;
+  uint8_t *plane;
+  std::vector <Input_Event> later;
+
+  for (i = 0; i < Times.size(); i++) Times[i].clear();
+  Run_Start = Now;
+  end = Now + duration + ((Run_Time_Inclusive) ? 1 : 0);
+  Sort_Pending();
+  p = 0;
+  n = H * W;
+
+  for (t = Now; t < end; t++) {
+
+    /* Nothing is in flight once nothing has fired for Max_Delay timesteps. */
+
+    if (t - Last_Spike > Max_Delay) {
+      if (p == Pending.size()) break;
+      if (Pending[p].Time > t) t = std::min(Pending[p].Time, end);
+      if (t == end) break;
+    }
+
+    for (i = 0; i < Layers.size(); i++) Layers[i].Charged = false;
+
+    /* Apply every stencil whose source fired delay timesteps ago. */
+
+    for (k = 0; k < Stencils.size(); k++) {
+      s = &Stencils[k];
+      F = &Layers[s->From];
+      slot = (t - s->Delay) % F->Planes.size();
+      if (F->Plane_Time[slot] != t - s->Delay) continue;
+      f = F->Planes[slot].data();
+      L = &Layers[s->To];
+      if (!L->Charged) {
+        std::fill(L->Charge.begin(), L->Charge.end(), 0);
+        L->Charged = true;
+      }
+      if (s->Kind == OFFSETS) {
+        for (j = 0; j < s->Offsets.size(); j++) {
+          Shifted_Add(f, s->Offsets[j].first, s->Offsets[j].second, s->Weight, L->Charge.data());
+        }
+      } else {
+        Box(f, *s, L->Charge.data());
+        if (s->Kind == BOX_MINUS_ONE) Shifted_Add(f, s->Missing_Dr, s->Missing_Dc, -s->Weight, L->Charge.data());
+      }
+    }
+
+    for (; p < Pending.size() && Pending[p].Time == t; p++) {
+      L = &Layers[Node_Layer[Pending[p].Node]];
+      if (!L->Charged) {
+        std::fill(L->Charge.begin(), L->Charge.end(), 0);
+        L->Charged = true;
+      }
+      v = L->Charge[Node_Cell[Pending[p].Node]] + Pending[p].Charge;
+      L->Charge[Node_Cell[Pending[p].Node]] = std::max(-32768, std::min(32767, v));
+    }
+
+    /* Fire.  The charge leaks away at the end of the timestep. */
+
+    for (i = 0; i < Layers.size(); i++) {
+      L = &Layers[i];
+      if (!L->Charged) continue;
+      slot = t % L->Planes.size();
+      plane = L->Planes[slot].data();
+      any = false;
+      for (c = 0; c < n; c++) {
+        plane[c] = (L->Charge[c] >= L->Threshold) & L->Exists[c];
+        any |= plane[c];
+      }
+      if (!any) continue;
+      L->Plane_Time[slot] = t;
+      Last_Spike = t;
+      if (!L->Output.empty()) {
+        for (c = 0; c < n; c++) {
+          if (plane[c] && L->Output[c] >= 0) Times[L->Output[c]].push_back(t - Run_Start);
+        }
+      }
+    }
+  }
+
+  later.assign(Pending.begin() + p, Pending.end());
+  Pending.swap(later);
+  Now = end;
+}
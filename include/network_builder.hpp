@@ -0,0 +1,874 @@
+/* Output of the network generators (src/dbscan_flat_*.cpp, src/dbscan_systolic_*.cpp and
+   their 3d_ versions), and of bin/network_convert.
+
+   The generators build their networks with the calls below, which correspond one-to-one to
+   the network_tool commands FJ, AN, AI, AO, SNP, SETNAME, AE, SEP, SORT Q and TJ.  The
+   format given to Start() says what a Network_Builder does with them:
+
+   - COMMANDS: Print the commands, and you make the network by piping them into
+     $fr/bin/network_tool.  This is the default.
+
+   - JSON: Write the network itself, in the framework's JSON format, so you don't need
+     network_tool at all.  The Properties, Network_Values and Associated_Data are copied
+     from the empty network.  Each edge is written once, with all of its values, as soon as
+     the next edge is added (or at Finish()), so the edges never sit in memory.  The nodes
+     are kept in a flat array, indexed by id, and written at Finish().  The edges come
+     before the nodes in the file.  That's fine, because JSON objects are unordered, and the
+     framework reads the nodes first regardless.
+
+   - BINARY: Write the binary format in include/snn_network.hpp.  That needs the synapses
+     grouped by their from node, so the edges are kept in memory (16 bytes each), in a
+     linked list per node, and written at Finish().
+
+   Either way, you have to set an edge's properties right after you add it -- which is what
+   every generator does.  Everything goes out through one big buffer with fwrite().  Values
+   that are never set are zero.  Errors (malformed or non-empty empty networks, unknown
+   properties, edges to nodes that don't exist) are fatal, like they are in network_tool.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <sstream>
+#include "snn_network.hpp"
+
+/* A JSON_Skimmer steps over JSON text without building anything.  That's all we need to
+   find the members of the empty network, or to walk the nodes and edges of a network.
+   Positions are indices into Text.  Errors are fatal, and What says what the text is. */
+
+class JSON_Skimmer {
+  public:
+    std::string Text;
+    std::string What;
+
+    size_t Skip_WS(size_t i);
+    size_t Skip_Value(size_t i);               /* Returns the position after the value */
+    size_t First(size_t i);                    /* At '{' or '[' -- the first member/element, or npos */
+    size_t Next(size_t i, char close);         /* After a member/element -- the next one, or npos */
+    size_t Member(size_t i, std::string &key); /* Parse "key": at i, and return the value's start */
+    std::string String(size_t i);              /* The string at i, unescaped (but not unicode escapes) */
+    double Number(size_t i);
+
+    void Fatal(const char *fmt, ...) __attribute__ ((format (printf, 2, 3), noreturn));
+};
+
+class Network_Builder {
+  public:
+    ~Network_Builder();
+
+    void Start(const std::string &emptynet, const std::string &format);     /* FJ */
+    void Add_Node(int id);                                                  /* AN */
+    void Add_Input(int id);                                                 /* AI */
+    void Add_Output(int id);                                                /* AO */
+    void Set_Node_Property(int id, const char *prop, double v);             /* SNP */
+    void Set_Name(int id, const char *fmt, ...)                             /* SETNAME, printf-style */
+      __attribute__ ((format (printf, 3, 4)));
+    void Add_Edge(int from, int to);                                        /* AE */
+    void Set_Edge_Property(int from, int to, const char *prop, double v);   /* SEP */
+    void Finish();                                                          /* SORT Q and TJ */
+
+    /* Start from the JSON text of a network (its nodes, edges, inputs and outputs are
+       ignored), and set values by their index rather than name.  These can't make
+       COMMANDS, because there's no empty network file for FJ. */
+
+    void Start_JSON(const std::string &network, const std::string &format);
+    void Set_Node_Value(int id, int index, double v);
+    void Set_Edge_Value(int from, int to, int index, double v);
+
+    /* Convert a whole network, from network_tool commands, the text of a JSON network, or
+       a binary network, to format.  Call Finish() afterward. */
+
+    void Read_Commands(const std::string &text, const std::string &format);
+    void Read_JSON(const std::string &text, const std::string &format);
+    void Read_Binary(const SNN_Network &b, const std::string &format);
+
+    /* Append the output to *s rather than writing it to standard output. */
+
+    void Write_To(std::string *s) { Mem = s; }
+
+  protected:
+    struct Property {
+      std::string Name;
+      int Index;
+    };
+
+    std::string Format = "COMMANDS";
+    JSON_Skimmer J;                            /* The empty network */
+    std::string Empty;                         /* ... rewritten without nodes/edges/inputs/outputs */
+    size_t Props = 0, Props_End = 0;           /* Where "Properties" is in J.Text */
+    std::string Values, Data;                  /* "Network_Values" and "Associated_Data" */
+    std::vector <Property> Node_Props, Edge_Props;
+    int Node_Size = 0, Edge_Size = 0;          /* Number of values per node / edge */
+
+    std::vector <char> Exists;                 /* The nodes, indexed by id */
+    std::vector <double> Node_Values;
+    std::vector <std::string> Names;
+    std::vector <int> Inputs, Outputs;
+
+    bool Pending = false;                      /* The last edge added, which isn't written yet */
+    int Pending_From = 0, Pending_To = 0;
+    std::vector <double> Pending_Values;
+    long long Edges = 0;
+
+    int Threshold_Index, Weight_Index, Delay_Index;   /* For BINARY */
+    std::vector <SNN_Synapse> Synapses;        /* The edges, in the order that they're added */
+    std::vector <uint32_t> Next;               /* Next edge from the same node, or -1 */
+    std::vector <uint32_t> Head, Tail;         /* The first and last edge from each node */
+
+    std::vector <char> Buf;                    /* The output buffer */
+    size_t Len = 0;
+    std::string *Mem = NULL;                   /* From Write_To() */
+    uint64_t Total = 0;                        /* Bytes written so far */
+
+    void Parse_Properties(size_t i, const char *key, std::vector <Property> &props, int &size);
+    int Find_Property(const std::vector <Property> &props, const char *prop);
+    bool Exists_Node(int id) const { return id >= 0 && id < (int) Exists.size() && Exists[id]; }
+
+    std::string FJ_File;                       /* COMMANDS: the FJ that Commands() prints */
+    bool FJ_Pending = false;
+
+    bool Commands();                           /* COMMANDS mode?  Prints the FJ first. */
+    void Flush();
+    void Put(const void *s, size_t n);
+    void Put(const char *s) { Put(s, strlen(s)); }
+    void Pad();                                /* Pad to a multiple of 8 bytes */
+    void Put_Int(long long v);
+    void Put_Value(double v);
+    void Put_Values(const double *v, int n);
+    void Write_Pending_Edge();
+    void Finish_JSON();
+    void Finish_Binary();
+};
+
+/* ------------------------------------------------------------ */
+/* JSON_Skimmer */
+
+inline void JSON_Skimmer::Fatal(const char *fmt, ...)
+{
+  va_list ap;
+
+  fprintf(stderr, "Bad %s -- ", What.c_str());
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+inline size_t JSON_Skimmer::Skip_WS(size_t i)
+{
+  while (i < Text.size() && strchr(" \t\r\n", Text[i]) != NULL && Text[i] != '\0') i++;
+  return i;
+}
+
+inline size_t JSON_Skimmer::Skip_Value(size_t i)
+{
+  int depth;
+  bool in_string;
+
+  if (i >= Text.size()) Fatal("unexpected end of file");
+  if (strchr("{[\"", Text[i]) == NULL || Text[i] == '\0') {
+    while (i < Text.size() && strchr(",}] \t\r\n", Text[i]) == NULL) i++;
+    return i;
+  }
+  depth = 0;
+  in_string = false;
+  for (; i < Text.size(); i++) {
+    if (in_string) {
+      if (Text[i] == '\\') i++;
+      else if (Text[i] == '"') {
+        in_string = false;
+        if (depth == 0) return i+1;
+      }
+    } else if (Text[i] == '"') {
+      in_string = true;
+    } else if (Text[i] == '{' || Text[i] == '[') {
+      depth++;
+    } else if (Text[i] == '}' || Text[i] == ']') {
+      depth--;
+      if (depth == 0) return i+1;
+    }
+  }
+  Fatal("unexpected end of file");
+}
+
+inline size_t JSON_Skimmer::First(size_t i)
+{
+  size_t j;
+
+  i = Skip_WS(i);
+  if (i >= Text.size() || (Text[i] != '{' && Text[i] != '[')) Fatal("expected '{' or '[' at byte %zu", i);
+  j = Skip_WS(i+1);
+  if (j < Text.size() && Text[j] == ((Text[i] == '{') ? '}' : ']')) return std::string::npos;
+  return j;
+}
+
+inline size_t JSON_Skimmer::Next(size_t i, char close)
+{
+  i = Skip_WS(i);
+  if (i < Text.size() && Text[i] == ',') return Skip_WS(i+1);
+  if (i < Text.size() && Text[i] == close) return std::string::npos;
+  Fatal("expected ',' or '%c' at byte %zu", close, i);
+}
+
+inline size_t JSON_Skimmer::Member(size_t i, std::string &key)
+{
+  i = Skip_WS(i);
+  key = String(i);
+  i = Skip_WS(Skip_Value(i));
+  if (i >= Text.size() || Text[i] != ':') Fatal("expected ':' at byte %zu", i);
+  return Skip_WS(i+1);
+}
+
+inline std::string JSON_Skimmer::String(size_t i)
+{
+  std::string s;
+  size_t j, end;
+
+  if (i >= Text.size() || Text[i] != '"') Fatal("expected a string at byte %zu", i);
+  end = Skip_Value(i) - 1;
+  for (j = i+1; j < end; j++) {
+    if (Text[j] == '\\') {
+      j++;
+      s.push_back((Text[j] == 'n') ? '\n' : (Text[j] == 't') ? '\t' : Text[j]);
+    } else {
+      s.push_back(Text[j]);
+    }
+  }
+  return s;
+}
+
+inline double JSON_Skimmer::Number(size_t i)
+{
+  char *end;
+  double v;
+
+  v = strtod(Text.c_str() + i, &end);
+  if (end == Text.c_str() + i) Fatal("expected a number at byte %zu", i);
+  return v;
+}
+
+/* ------------------------------------------------------------ */
+/* Parsing the empty network.  This only needs to find the top-level members, and the name
+   and index of each property. */
+
+/* Find the name and index of each property in node_properties or edge_properties.  The
+   number of values per node/edge is the largest index+size. */
+
+inline void Network_Builder::Parse_Properties(size_t i, const char *key,
+                                              std::vector <Property> &props, int &size)
+{
+  std::string k;
+  size_t j, p, q, v;
+  Property prop;
+  int psize;
+
+  for (j = J.First(i); j != std::string::npos; j = J.Next(J.Skip_Value(v), '}')) {
+    v = J.Member(j, k);
+    if (k != key) continue;
+    for (p = J.First(v); p != std::string::npos; p = J.Next(J.Skip_Value(p), ']')) {
+      prop.Name = "";
+      prop.Index = -1;
+      psize = 1;
+      for (q = J.First(p); q != std::string::npos; q = J.Next(J.Skip_Value(q), '}')) {
+        q = J.Member(q, k);
+        if (k == "name") prop.Name = J.String(q);
+        if (k == "index") prop.Index = J.Number(q);
+        if (k == "size") psize = J.Number(q);
+      }
+      if (prop.Name == "" || prop.Index < 0) J.Fatal("a property in %s has no name or index", key);
+      props.push_back(prop);
+      if (prop.Index + psize > size) size = prop.Index + psize;
+    }
+  }
+}
+
+inline int Network_Builder::Find_Property(const std::vector <Property> &props, const char *prop)
+{
+  size_t i;
+
+  for (i = 0; i < props.size(); i++) if (props[i].Name == prop) return props[i].Index;
+  fprintf(stderr, "Property %s is not in the empty network\n", prop);
+  exit(1);
+}
+
+/* ------------------------------------------------------------ */
+/* The buffered writer. */
+
+inline void Network_Builder::Flush()
+{
+  if (Mem != NULL) {
+    Mem->append(Buf.data(), Len);
+  } else if (Len > 0 && fwrite(Buf.data(), 1, Len, stdout) != Len) {
+    perror("Writing the network");
+    exit(1);
+  }
+  Len = 0;
+}
+
+inline void Network_Builder::Put(const void *s, size_t n)
+{
+  Total += n;
+  if (Mem != NULL) {
+    Mem->append((const char *) s, n);
+    return;
+  }
+  if (Len + n > Buf.size()) {
+    Flush();
+    if (n > Buf.size()) {
+      if (fwrite(s, 1, n, stdout) != n) { perror("Writing the network"); exit(1); }
+      return;
+    }
+  }
+  memcpy(Buf.data() + Len, s, n);
+  Len += n;
+}
+
+inline void Network_Builder::Put_Int(long long v)
+{
+  char s[24];
+  int i;
+  unsigned long long u;
+
+  i = sizeof(s);
+  u = (v < 0) ? -(unsigned long long) v : v;
+  do { s[--i] = '0' + u % 10; u /= 10; } while (u != 0);
+  if (v < 0) s[--i] = '-';
+  Put(s+i, sizeof(s)-i);
+}
+
+inline void Network_Builder::Put_Value(double v)
+{
+  char s[32];
+
+  if (v == (double) (long long) v && v > -1e15 && v < 1e15) {
+    Put_Int((long long) v);
+  } else {
+    Put(s, snprintf(s, sizeof(s), "%.17g", v));
+  }
+}
+
+inline void Network_Builder::Put_Values(const double *v, int n)
+{
+  int i;
+
+  Put("[", 1);
+  for (i = 0; i < n; i++) {
+    if (i != 0) Put(",", 1);
+    Put_Value(v[i]);
+  }
+  Put("]", 1);
+}
+
+/* ------------------------------------------------------------ */
+/* The network_tool commands. */
+
+inline Network_Builder::~Network_Builder()
+{
+  Flush();
+}
+
+inline void Network_Builder::Start(const std::string &emptynet, const std::string &format)
+{
+  FILE *f;
+  char block[65536];
+  size_t n, i, v;
+  std::string text, k;
+
+  if (format == "COMMANDS") {
+    FJ_File = emptynet;
+    FJ_Pending = true;
+    return;
+  }
+
+  f = fopen(emptynet.c_str(), "r");
+  if (f == NULL) { perror(emptynet.c_str()); exit(1); }
+  while ((n = fread(block, 1, sizeof(block), f)) > 0) text.append(block, n);
+  fclose(f);
+
+  Start_JSON(text, format);
+
+  for (i = J.First(0); i != std::string::npos; i = J.Next(J.Skip_Value(v), '}')) {
+    v = J.Member(i, k);
+    if ((k == "Nodes" || k == "Edges" || k == "Inputs" || k == "Outputs") &&
+        J.First(v) != std::string::npos) {
+      fprintf(stderr, "The empty network's %s has to be empty\n", k.c_str());
+      exit(1);
+    }
+  }
+}
+
+inline void Network_Builder::Start_JSON(const std::string &network, const std::string &format)
+{
+  std::string k;
+  size_t i, v;
+
+  if (format != "JSON" && format != "BINARY") {
+    fprintf(stderr, "Bad network format %s -- it has to be COMMANDS, JSON or BINARY\n", format.c_str());
+    exit(1);
+  }
+  Format = format;
+  J.Text = network;
+  J.What = "empty network";
+
+  Values = "[]";
+  Data = "{}";
+  for (i = J.First(0); i != std::string::npos; i = J.Next(J.Skip_Value(v), '}')) {
+    v = J.Member(i, k);
+    if (k == "Properties") {
+      Props = v;
+      Props_End = J.Skip_Value(v);
+      Parse_Properties(v, "node_properties", Node_Props, Node_Size);
+      Parse_Properties(v, "edge_properties", Edge_Props, Edge_Size);
+    } else if (k == "Network_Values") {
+      Values = J.Text.substr(v, J.Skip_Value(v) - v);
+    } else if (k == "Associated_Data") {
+      Data = J.Text.substr(v, J.Skip_Value(v) - v);
+    }
+  }
+  if (Props_End == 0) J.Fatal("no Properties");
+
+  Empty = "{ \"Properties\": " + J.Text.substr(Props, Props_End - Props) + ",\n";
+  Empty += " \"Nodes\": [],\n \"Edges\": [],\n \"Inputs\": [],\n \"Outputs\": [],\n";
+  Empty += " \"Network_Values\": " + Values + ",\n \"Associated_Data\": " + Data + " }\n";
+
+  Pending_Values.resize(Edge_Size);
+  Buf.resize(1 << 20);
+
+  if (Format == "BINARY") {
+    Threshold_Index = Find_Property(Node_Props, "Threshold");
+    Weight_Index = Find_Property(Edge_Props, "Weight");
+    Delay_Index = Find_Property(Edge_Props, "Delay");
+  } else {
+    Put("{ \"Properties\": ");
+    Put(J.Text.c_str() + Props, Props_End - Props);
+    Put(",\n \"Edges\": [");
+  }
+}
+
+/* In COMMANDS mode, FJ isn't printed until the first command, so that a generator that
+   rejects its arguments, and exits before it makes anything, doesn't print a partial network
+   (the generators check their arguments after Start()). */
+
+inline bool Network_Builder::Commands()
+{
+  if (Format != "COMMANDS") return false;
+  if (FJ_Pending) {
+    printf("FJ %s\n", FJ_File.c_str());
+    FJ_Pending = false;
+  }
+  return true;
+}
+
+inline void Network_Builder::Add_Node(int id)
+{
+  if (Commands()) { printf("AN %d\n", id); return; }
+  if (id < 0) { fprintf(stderr, "AN %d -- bad node id\n", id); exit(1); }
+  if (id >= (int) Exists.size()) {
+    Exists.resize(id+1, 0);
+    Names.resize(id+1);
+    Node_Values.resize((size_t) (id+1) * Node_Size, 0);
+  }
+  if (Exists[id]) { fprintf(stderr, "AN %d -- node already exists\n", id); exit(1); }
+  Exists[id] = 1;
+}
+
+inline void Network_Builder::Add_Input(int id)
+{
+  if (Commands()) { printf("AI %d\n", id); return; }
+  if (!Exists_Node(id)) { fprintf(stderr, "AI %d -- no such node\n", id); exit(1); }
+  Inputs.push_back(id);
+}
+
+inline void Network_Builder::Add_Output(int id)
+{
+  if (Commands()) { printf("AO %d\n", id); return; }
+  if (!Exists_Node(id)) { fprintf(stderr, "AO %d -- no such node\n", id); exit(1); }
+  Outputs.push_back(id);
+}
+
+inline void Network_Builder::Set_Node_Property(int id, const char *prop, double v)
+{
+  if (Commands()) { printf("SNP %d %s %.17g\n", id, prop, v); return; }
+  Set_Node_Value(id, Find_Property(Node_Props, prop), v);
+}
+
+inline void Network_Builder::Set_Node_Value(int id, int index, double v)
+{
+  if (!Exists_Node(id)) { fprintf(stderr, "SNP %d -- no such node\n", id); exit(1); }
+  if (index < 0 || index >= Node_Size) { fprintf(stderr, "SNP %d -- bad value index %d\n", id, index); exit(1); }
+  Node_Values[(size_t) id * Node_Size + index] = v;
+}
+
+inline void Network_Builder::Set_Name(int id, const char *fmt, ...)
+{
+  char name[256];
+  va_list ap;
+
+  va_start(ap, fmt);
+  vsnprintf(name, sizeof(name), fmt, ap);
+  va_end(ap);
+  if (Commands()) { printf("SETNAME %d %s\n", id, name); return; }
+  if (!Exists_Node(id)) { fprintf(stderr, "SETNAME %d -- no such node\n", id); exit(1); }
+  Names[id] = name;
+}
+
+inline void Network_Builder::Add_Edge(int from, int to)
+{
+  if (Commands()) { printf("AE %d %d\n", from, to); return; }
+  if (!Exists_Node(from) || !Exists_Node(to)) {
+    fprintf(stderr, "AE %d %d -- no such node\n", from, to);
+    exit(1);
+  }
+  Write_Pending_Edge();
+  Pending = true;
+  Pending_From = from;
+  Pending_To = to;
+  std::fill(Pending_Values.begin(), Pending_Values.end(), 0);
+}
+
+inline void Network_Builder::Set_Edge_Property(int from, int to, const char *prop, double v)
+{
+  if (Commands()) { printf("SEP %d %d %s %.17g\n", from, to, prop, v); return; }
+  Set_Edge_Value(from, to, Find_Property(Edge_Props, prop), v);
+}
+
+inline void Network_Builder::Set_Edge_Value(int from, int to, int index, double v)
+{
+  if (!Pending || from != Pending_From || to != Pending_To) {
+    fprintf(stderr, "SEP %d %d -- edge properties have to be set right after the edge is added\n", from, to);
+    exit(1);
+  }
+  if (index < 0 || index >= Edge_Size) { fprintf(stderr, "SEP %d %d -- bad value index %d\n", from, to, index); exit(1); }
+  Pending_Values[index] = v;
+}
+
+inline void Network_Builder::Write_Pending_Edge()
+{
+  SNN_Synapse s;
+
+  if (!Pending) return;
+  Pending = false;
+  Edges++;
+
+  if (Format == "JSON") {
+    Put((Edges == 1) ? "\n  {\"from\":" : ",\n  {\"from\":");
+    Put_Int(Pending_From);
+    Put(",\"to\":");
+    Put_Int(Pending_To);
+    Put(",\"values\":");
+    Put_Values(Pending_Values.data(), Edge_Size);
+    Put("}", 1);
+    return;
+  }
+
+  if (Synapses.size() == 0xffffffffUL) { fprintf(stderr, "Too many edges for a binary network\n"); exit(1); }
+  s.To = Pending_To;
+  s.Weight = Pending_Values[Weight_Index];
+  s.Delay = Pending_Values[Delay_Index];
+  if (Pending_From >= (int) Head.size()) {
+    Head.resize(Pending_From+1, 0xffffffff);
+    Tail.resize(Pending_From+1, 0xffffffff);
+  }
+  if (Head[Pending_From] == 0xffffffff) {
+    Head[Pending_From] = Synapses.size();
+  } else {
+    Next[Tail[Pending_From]] = Synapses.size();
+  }
+  Tail[Pending_From] = Synapses.size();
+  Synapses.push_back(s);
+  Next.push_back(0xffffffff);
+}
+
+inline void Network_Builder::Finish()
+{
+  if (Commands()) {
+    printf("SORT Q\n");
+    printf("TJ\n");
+    return;
+  }
+  Write_Pending_Edge();
+  if (Format == "JSON") {
+    Finish_JSON();
+  } else {
+    Finish_Binary();
+  }
+  Flush();
+}
+
+inline void Network_Builder::Finish_JSON()
+{
+  size_t i, j;
+  bool first;
+
+  Put("],\n \"Nodes\": [");
+  first = true;
+  for (i = 0; i < Exists.size(); i++) {
+    if (!Exists[i]) continue;
+    Put(first ? "\n  {\"id\":" : ",\n  {\"id\":");
+    first = false;
+    Put_Int(i);
+    if (Names[i] != "") {
+      Put(",\"name\":\"");
+      for (j = 0; j < Names[i].size(); j++) {
+        if (Names[i][j] == '"' || Names[i][j] == '\\') Put("\\", 1);
+        Put(&Names[i][j], 1);
+      }
+      Put("\"");
+    }
+    Put(",\"values\":");
+    Put_Values(Node_Values.data() + i * Node_Size, Node_Size);
+    Put("}", 1);
+  }
+  Put("],\n \"Inputs\": [");
+  for (i = 0; i < Inputs.size(); i++) {
+    if (i != 0) Put(",", 1);
+    Put_Int(Inputs[i]);
+  }
+  Put("],\n \"Outputs\": [");
+  for (i = 0; i < Outputs.size(); i++) {
+    if (i != 0) Put(",", 1);
+    Put_Int(Outputs[i]);
+  }
+  Put("],\n \"Network_Values\": ");
+  Put(Values.c_str());
+  Put(",\n \"Associated_Data\": ");
+  Put(Data.c_str());
+  Put(" }\n");
+}
+
+inline void Network_Builder::Pad()
+{
+  static const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  if (Total % 8 != 0) Put(zeros, 8 - Total % 8);
+}
+
+inline void Network_Builder::Finish_Binary()
+{
+  SNN_Header h;
+  uint64_t i, n, off;
+  uint32_t e;
+  float t;
+
+  for (i = 0; i < Exists.size(); i++) {
+    if (!Exists[i]) {
+      fprintf(stderr, "Binary networks need nodes numbered 0..n-1, and node %llu is missing\n",
+              (unsigned long long) i);
+      exit(1);
+    }
+  }
+  n = Exists.size();
+  Head.resize(n, 0xffffffff);
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.Magic, SNN_MAGIC, 8);
+  h.Nodes = n;
+  h.Edges = Synapses.size();
+  h.Num_Inputs = Inputs.size();
+  h.Num_Outputs = Outputs.size();
+  h.Names_Size = 0;
+  for (i = 0; i < n; i++) h.Names_Size += Names[i].size() + 1;
+  h.Empty_Size = Empty.size() + 1;
+  SNN_Layout(h);
+
+  Put(&h, sizeof(h));
+  for (i = 0; i < n; i++) {
+    t = Node_Values[i * Node_Size + Threshold_Index];
+    Put(&t, sizeof(t));
+  }
+  Pad();
+
+  off = 0;
+  Put(&off, sizeof(off));
+  for (i = 0; i < n; i++) {
+    for (e = Head[i]; e != 0xffffffff; e = Next[e]) off++;
+    Put(&off, sizeof(off));
+  }
+  for (i = 0; i < n; i++) {
+    for (e = Head[i]; e != 0xffffffff; e = Next[e]) Put(&Synapses[e], sizeof(SNN_Synapse));
+  }
+  Pad();
+
+  for (i = 0; i < Inputs.size(); i++) Put(&Inputs[i], sizeof(int32_t));
+  Pad();
+  for (i = 0; i < Outputs.size(); i++) Put(&Outputs[i], sizeof(int32_t));
+  Pad();
+
+  off = 0;
+  Put(&off, sizeof(off));
+  for (i = 0; i < n; i++) {
+    off += Names[i].size() + 1;
+    Put(&off, sizeof(off));
+  }
+  for (i = 0; i < n; i++) Put(Names[i].c_str(), Names[i].size() + 1);
+  Pad();
+
+  Put(Empty.c_str(), Empty.size() + 1);
+}
+
+/* ------------------------------------------------------------ */
+/* Reading whole networks. */
+
+/* Replay network_tool commands.  These are just the commands that Network_Builder makes. */
+
+inline void Network_Builder::Read_Commands(const std::string &text, const std::string &format)
+{
+  std::istringstream ss(text);
+  std::string line, cmd, s;
+  std::istringstream ls;
+  int ln, a, b;
+  double v;
+  bool ok, started;
+
+  ln = 0;
+  started = false;
+  while (std::getline(ss, line)) {
+    ln++;
+    ls.clear();
+    ls.str(line);
+    if (!(ls >> cmd)) continue;
+    ok = true;
+    if (cmd != "FJ" && !started) {
+      fprintf(stderr, "Line %d: the commands have to start with FJ\n", ln);
+      exit(1);
+    }
+    if (cmd == "FJ") {
+      if (started) { fprintf(stderr, "Line %d: only one FJ, please\n", ln); exit(1); }
+      started = true;
+      ok = (bool) (ls >> s);
+      if (ok) Start(s, format);
+    } else if (cmd == "AN" || cmd == "AI" || cmd == "AO") {
+      ok = (bool) (ls >> a);
+      if (ok && cmd == "AN") Add_Node(a);
+      if (ok && cmd == "AI") Add_Input(a);
+      if (ok && cmd == "AO") Add_Output(a);
+    } else if (cmd == "SNP") {
+      ok = (bool) (ls >> a >> s >> v);
+      if (ok) Set_Node_Property(a, s.c_str(), v);
+    } else if (cmd == "SETNAME") {
+      ok = (bool) (ls >> a >> s);
+      if (ok) Set_Name(a, "%s", s.c_str());
+    } else if (cmd == "AE") {
+      ok = (bool) (ls >> a >> b);
+      if (ok) Add_Edge(a, b);
+    } else if (cmd == "SEP") {
+      ok = (bool) (ls >> a >> b >> s >> v);
+      if (ok) Set_Edge_Property(a, b, s.c_str(), v);
+    } else if (cmd != "SORT" && cmd != "TJ") {
+      fprintf(stderr, "Line %d: unknown command %s\n", ln, cmd.c_str());
+      exit(1);
+    }
+    if (!ok) {
+      fprintf(stderr, "Line %d: bad %s command\n", ln, cmd.c_str());
+      exit(1);
+    }
+  }
+  if (!started) { fprintf(stderr, "There are no network_tool commands\n"); exit(1); }
+}
+
+/* Walk the Nodes, Edges, Inputs and Outputs of a JSON network.  Nodes have to be added
+   before the edges, and they may come in either order in the file, so first find where
+   each one is. */
+
+inline void Network_Builder::Read_JSON(const std::string &text, const std::string &format)
+{
+  JSON_Skimmer j;
+  std::string k;
+  size_t i, v, p, q, nodes, edges, inputs, outputs;
+  int id, from, to, index;
+  std::string name;
+
+  Start_JSON(text, format);
+
+  j.Text = text;
+  j.What = "JSON network";
+  nodes = edges = inputs = outputs = std::string::npos;
+  for (i = j.First(0); i != std::string::npos; i = j.Next(j.Skip_Value(v), '}')) {
+    v = j.Member(i, k);
+    if (k == "Nodes") nodes = v;
+    if (k == "Edges") edges = v;
+    if (k == "Inputs") inputs = v;
+    if (k == "Outputs") outputs = v;
+  }
+  if (nodes == std::string::npos || edges == std::string::npos || inputs == std::string::npos ||
+      outputs == std::string::npos) {
+    j.Fatal("it needs Nodes, Edges, Inputs and Outputs");
+  }
+
+  for (p = j.First(nodes); p != std::string::npos; p = j.Next(j.Skip_Value(p), ']')) {
+    id = -1;
+    name = "";
+    v = std::string::npos;
+    for (q = j.First(p); q != std::string::npos; q = j.Next(j.Skip_Value(q), '}')) {
+      q = j.Member(q, k);
+      if (k == "id") id = j.Number(q);
+      if (k == "name") name = j.String(q);
+      if (k == "values") v = q;
+    }
+    Add_Node(id);
+    if (name != "") Set_Name(id, "%s", name.c_str());
+    if (v != std::string::npos) {
+      index = 0;
+      for (q = j.First(v); q != std::string::npos; q = j.Next(j.Skip_Value(q), ']')) {
+        Set_Node_Value(id, index, j.Number(q));
+        index++;
+      }
+    }
+  }
+
+  for (p = j.First(edges); p != std::string::npos; p = j.Next(j.Skip_Value(p), ']')) {
+    from = -1;
+    to = -1;
+    v = std::string::npos;
+    for (q = j.First(p); q != std::string::npos; q = j.Next(j.Skip_Value(q), '}')) {
+      q = j.Member(q, k);
+      if (k == "from") from = j.Number(q);
+      if (k == "to") to = j.Number(q);
+      if (k == "values") v = q;
+    }
+    Add_Edge(from, to);
+    if (v != std::string::npos) {
+      index = 0;
+      for (q = j.First(v); q != std::string::npos; q = j.Next(j.Skip_Value(q), ']')) {
+        Set_Edge_Value(from, to, index, j.Number(q));
+        index++;
+      }
+    }
+  }
+
+  for (p = j.First(inputs); p != std::string::npos; p = j.Next(j.Skip_Value(p), ']')) {
+    Add_Input(j.Number(p));
+  }
+  for (p = j.First(outputs); p != std::string::npos; p = j.Next(j.Skip_Value(p), ']')) {
+    Add_Output(j.Number(p));
+  }
+}
+
+inline void Network_Builder::Read_Binary(const SNN_Network &b, const std::string &format)
+{
+  uint64_t i, e;
+
+  Start_JSON(b.Empty_Network, format);
+  for (i = 0; i < b.Nodes; i++) {
+    Add_Node(i);
+    if (b.Name(i)[0] != '\0') Set_Name(i, "%s", b.Name(i));
+    Set_Node_Property(i, "Threshold", b.Threshold[i]);
+  }
+  for (i = 0; i < b.Nodes; i++) {
+    for (e = b.Edge_Start[i]; e < b.Edge_Start[i+1]; e++) {
+      Add_Edge(i, b.Synapses[e].To);
+      Set_Edge_Property(i, b.Synapses[e].To, "Weight", b.Synapses[e].Weight);
+      Set_Edge_Property(i, b.Synapses[e].To, "Delay", b.Synapses[e].Delay);
+    }
+  }
+  for (i = 0; i < b.Num_Inputs; i++) Add_Input(b.Inputs[i]);
+  for (i = 0; i < b.Num_Outputs; i++) Add_Output(b.Outputs[i]);
+}
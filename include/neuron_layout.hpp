@@ -0,0 +1,77 @@
+/* Neuron numbers for the network generators (src/dbscan_flat_*.cpp, src/dbscan_systolic_*.cpp
+   and their 3d_ versions).
+
+   The networks are made of layers of neurons named I, C, Core, B and Border, plus e_t layers
+   each of Mem_I and Mem_Core in 3D, and each neuron is indexed by its row and column in its
+   layer.  A Neuron_Layer holds the neuron numbers of a layer in one flat array, which covers
+   the layer plus a halo around it.  Entries for neurons that don't exist, including the
+   whole halo, are -1, so the generators can look up a neighbor that is off the edge of the
+   layer, and skip the synapse when they get -1.  A lookup is just an index computation, and
+   there is no heap memory per neuron.
+
+   Rows and columns may be negative (the systolic networks number their columns -e..e), so
+   Setup() takes the first row and column and one past the last ones, including the halo.
+   A lookup outside of that is a bug in the generator, so it is a fatal error.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+class Neuron_Layer {
+  public:
+    void Setup(int row_lo, int row_hi, int col_lo, int col_hi);
+    int &operator()(int r, int c);
+
+  protected:
+    int R0 = 0, C0 = 0, Rows = 0, Cols = 0;
+    std::vector <int> Ids;
+};
+
+class Neuron_Layout {
+  public:
+    Neuron_Layer I, C, Core, B, Border;
+    std::vector <Neuron_Layer> Mem_I, Mem_Core;
+
+    /* Every layer covers rows row_lo..row_hi-1 and columns col_lo..col_hi-1. */
+
+    void Setup(int row_lo, int row_hi, int col_lo, int col_hi, int mem_layers);
+};
+
+inline void Neuron_Layer::Setup(int row_lo, int row_hi, int col_lo, int col_hi)
+{
+  R0 = row_lo;
+  C0 = col_lo;
+  Rows = (row_hi > row_lo) ? row_hi - row_lo : 0;
+  Cols = (col_hi > col_lo) ? col_hi - col_lo : 0;
+  Ids.assign((size_t) Rows * Cols, -1);
+}
+
+inline int &Neuron_Layer::operator()(int r, int c)
+{
+  if (r < R0 || r >= R0 + Rows || c < C0 || c >= C0 + Cols) {
+    fprintf(stderr, "Internal error -- neuron [%d][%d] is outside of the layout\n", r, c);
+    exit(1);
+  }
+  return Ids[(size_t) (r - R0) * Cols + (c - C0)];
+}
+
+inline void Neuron_Layout::Setup(int row_lo, int row_hi, int col_lo, int col_hi, int mem_layers)
+{
+  int i;
+
+  I.Setup(row_lo, row_hi, col_lo, col_hi);
+  C.Setup(row_lo, row_hi, col_lo, col_hi);
+  Core.Setup(row_lo, row_hi, col_lo, col_hi);
+  B.Setup(row_lo, row_hi, col_lo, col_hi);
+  Border.Setup(row_lo, row_hi, col_lo, col_hi);
+  Mem_I.resize(mem_layers);
+  Mem_Core.resize(mem_layers);
+  for (i = 0; i < mem_layers; i++) {
+    Mem_I[i].Setup(row_lo, row_hi, col_lo, col_hi);
+    Mem_Core[i].Setup(row_lo, row_hi, col_lo, col_hi);
+  }
+}
@@ -0,0 +1,199 @@
+/* A compact binary format for the networks that the generators make, and a reader for it.
+
+   The JSON networks for camera-sized grids are hundreds of megabytes, and parsing them
+   takes longer than anything else.  A binary network is a header followed by flat arrays,
+   so reading one is an mmap() and some pointer arithmetic -- nothing is copied or parsed.
+   The generators write one when you put BINARY at the end of their command lines, and
+   bin/network_convert converts between this, JSON and network_tool commands.
+
+   The format is for RISP networks, whose nodes have a Threshold, and whose edges have a
+   Weight and a Delay.  Nodes are numbered 0..Nodes-1.  Everything is in the machine's byte
+   order, and every array starts on an 8-byte boundary:
+
+   - SNN_Header.
+   - float Threshold[Nodes].
+   - uint64_t Edge_Start[Nodes+1]: the synapses out of node i are Synapses[Edge_Start[i]]
+     to Synapses[Edge_Start[i+1]-1] (CSR).
+   - SNN_Synapse Synapses[Edges]: (to, weight, delay).
+   - int32_t Inputs[Num_Inputs] and int32_t Outputs[Num_Outputs]: node ids, in the order of
+     the input and output indices.
+   - uint64_t Name_Start[Nodes+1] and char Names[]: node i's name is the null-terminated
+     string at Names + Name_Start[i].  Nodes without names have "".
+   - char Empty_Network[]: the JSON of the empty network that the network was built on,
+     null-terminated, so that the Properties and Associated_Data survive a conversion.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SNN_MAGIC "SNNBIN01"
+
+struct SNN_Header {
+  char     Magic[8];                   /* SNN_MAGIC, without the null character */
+  uint64_t Nodes, Edges;
+  uint64_t Num_Inputs, Num_Outputs;
+  uint64_t Names_Size, Empty_Size;     /* Bytes in Names and Empty_Network */
+
+  /* Byte offsets of the arrays from the start of the file. */
+
+  uint64_t Threshold, Edge_Start, Synapses, Inputs, Outputs, Name_Start, Names, Empty_Network;
+};
+
+struct SNN_Synapse {
+  int32_t To;
+  float   Weight;
+  int32_t Delay;
+};
+
+/* Where the arrays go in a file, given the sizes in the header. */
+
+inline uint64_t SNN_Layout(SNN_Header &h)
+{
+  uint64_t off;
+
+  off = sizeof(SNN_Header);
+  h.Threshold = off;      off += (h.Nodes * sizeof(float) + 7) / 8 * 8;
+  h.Edge_Start = off;     off += (h.Nodes + 1) * sizeof(uint64_t);
+  h.Synapses = off;       off += (h.Edges * sizeof(SNN_Synapse) + 7) / 8 * 8;
+  h.Inputs = off;         off += (h.Num_Inputs * sizeof(int32_t) + 7) / 8 * 8;
+  h.Outputs = off;        off += (h.Num_Outputs * sizeof(int32_t) + 7) / 8 * 8;
+  h.Name_Start = off;     off += (h.Nodes + 1) * sizeof(uint64_t);
+  h.Names = off;          off += (h.Names_Size + 7) / 8 * 8;
+  h.Empty_Network = off;  off += h.Empty_Size;
+  return off;
+}
+
+/* SNN_Network maps a binary network into memory, read-only, and points into it.  Load()
+   mmaps a file.  From_Memory() uses a buffer that you own, and which has to outlive the
+   SNN_Network (e.g. when you read the network from standard input).  Errors are fatal. */
+
+class SNN_Network {
+  public:
+    ~SNN_Network();
+
+    void Load(const std::string &filename);
+    void From_Memory(const void *data, uint64_t size, const std::string &what);
+
+    uint64_t Nodes = 0, Edges = 0, Num_Inputs = 0, Num_Outputs = 0;
+    const float       *Threshold = NULL;
+    const uint64_t    *Edge_Start = NULL;
+    const SNN_Synapse *Synapses = NULL;
+    const int32_t     *Inputs = NULL;
+    const int32_t     *Outputs = NULL;
+    const char        *Empty_Network = NULL;
+
+    const char *Name(uint64_t node) const { return Names + Name_Start[node]; }
+
+  protected:
+    const uint64_t *Name_Start = NULL;
+    const char     *Names = NULL;
+    void           *Map = NULL;
+    uint64_t       Map_Size = 0;
+};
+
+/* Does this buffer start with a binary network? */
+
+inline bool SNN_Is_Binary(const void *data, uint64_t size)
+{
+  return (size >= 8 && memcmp(data, SNN_MAGIC, 8) == 0);
+}
+
+inline SNN_Network::~SNN_Network()
+{
+  if (Map != NULL) munmap(Map, Map_Size);
+}
+
+inline void SNN_Network::Load(const std::string &filename)
+{
+  int fd;
+  struct stat st;
+
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0 || fstat(fd, &st) < 0) { perror(filename.c_str()); exit(1); }
+  if (st.st_size < (off_t) sizeof(SNN_Header)) {
+    fprintf(stderr, "%s: not a binary network\n", filename.c_str());
+    exit(1);
+  }
+  Map_Size = st.st_size;
+  Map = mmap(NULL, Map_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (Map == MAP_FAILED) { perror(filename.c_str()); exit(1); }
+  close(fd);
+  From_Memory(Map, Map_Size, filename);
+}
+
+inline void SNN_Network::From_Memory(const void *data, uint64_t size, const std::string &what)
+{
+  SNN_Header h, l;
+  const char *base;
+  uint64_t i;
+
+  base = (const char *) data;
+  if (size < sizeof(SNN_Header) || !SNN_Is_Binary(data, size)) {
+    fprintf(stderr, "%s: not a binary network\n", what.c_str());
+    exit(1);
+  }
+  memcpy(&h, base, sizeof(h));
+
+  /* The offsets have to be exactly where SNN_Layout() puts them, which also checks that
+     the arrays are aligned and inside the file. */
+
+  l = h;
+  if (h.Nodes > size || h.Edges > size || h.Num_Inputs > size || h.Num_Outputs > size ||
+      h.Names_Size > size || h.Empty_Size > size || SNN_Layout(l) > size ||
+      memcmp(&l, &h, sizeof(h)) != 0 || h.Empty_Size == 0) {
+    fprintf(stderr, "%s: corrupt binary network\n", what.c_str());
+    exit(1);
+  }
+
+  Nodes = h.Nodes;
+  Edges = h.Edges;
+  Num_Inputs = h.Num_Inputs;
+  Num_Outputs = h.Num_Outputs;
+  Threshold = (const float *) (base + h.Threshold);
+  Edge_Start = (const uint64_t *) (base + h.Edge_Start);
+  Synapses = (const SNN_Synapse *) (base + h.Synapses);
+  Inputs = (const int32_t *) (base + h.Inputs);
+  Outputs = (const int32_t *) (base + h.Outputs);
+  Name_Start = (const uint64_t *) (base + h.Name_Start);
+  Names = base + h.Names;
+  Empty_Network = base + h.Empty_Network;
+
+  /* Check the indices, so that users can trust them.  This is one pass over the arrays,
+     which is a lot cheaper than parsing them. */
+
+  if (Edge_Start[0] != 0 || Edge_Start[Nodes] != Edges || Empty_Network[h.Empty_Size-1] != '\0' ||
+      Name_Start[0] != 0 || Name_Start[Nodes] != h.Names_Size) {
+    fprintf(stderr, "%s: corrupt binary network\n", what.c_str());
+    exit(1);
+  }
+  for (i = 0; i < Nodes; i++) {
+    if (Edge_Start[i] > Edge_Start[i+1] || Name_Start[i] >= Name_Start[i+1] ||
+        Names[Name_Start[i+1]-1] != '\0') {
+      fprintf(stderr, "%s: corrupt binary network\n", what.c_str());
+      exit(1);
+    }
+  }
+  for (i = 0; i < Edges; i++) {
+    if (Synapses[i].To < 0 || (uint64_t) Synapses[i].To >= Nodes) {
+      fprintf(stderr, "%s: corrupt binary network -- synapse %llu\n", what.c_str(), (unsigned long long) i);
+      exit(1);
+    }
+  }
+  for (i = 0; i < Num_Inputs + Num_Outputs; i++) {
+    if ((i < Num_Inputs && (Inputs[i] < 0 || (uint64_t) Inputs[i] >= Nodes)) ||
+        (i >= Num_Inputs && (Outputs[i-Num_Inputs] < 0 || (uint64_t) Outputs[i-Num_Inputs] >= Nodes))) {
+      fprintf(stderr, "%s: corrupt binary network -- bad input/output\n", what.c_str());
+      exit(1);
+    }
+  }
+}
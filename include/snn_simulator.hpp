@@ -0,0 +1,386 @@
+/* An event-driven simulator for the RISP networks that the dbscan_xxx and 3d_dbscan_xxx
+   programs make, so that you can run them without the framework's processor_tool.
+
+   It only does the subset of RISP that these networks use, and Load() checks that the
+   network's proc_params agree: "discrete" is true, "leak_mode" is "all", and thresholds,
+   weights, delays and input values are integers.  With leak "all", a neuron's potential
+   only lasts for one timestep, so a neuron fires at time t exactly when the charge that
+   arrives at time t reaches its threshold.  When it fires, each of its synapses delivers
+   its weight at t+delay.
+
+   The charge in flight is kept in a timing wheel: a ring of max_delay+1 buckets of
+   (to, weight), where bucket t%(max_delay+1) holds everything that arrives at time t.
+   A timestep empties its bucket into the neurons that it touches, checks those neurons
+   against their thresholds, and puts the synapses of the ones that fire into later
+   buckets.  Nothing else is visited, so the cost is proportional to the number of spikes,
+   not to the size of the network, and when nothing is in flight, Run() jumps straight to
+   the next input spike.
+
+   Like the processor_tool, input spike times are relative to the start of the next Run(),
+   and output spike times are relative to the start of the last one.  Charge that is still
+   in flight at the end of a Run() carries over to the next one.  Errors are fatal.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdarg>
+#include "snn_network.hpp"
+#include "network_builder.hpp"
+
+class SNN_Simulator {
+  public:
+    virtual ~SNN_Simulator() {}
+
+    virtual void Load(const SNN_Network &net);
+
+    void Apply_Spike(int input, int time, double value);     /* input is an input index */
+    virtual void Run(int duration);
+    virtual void Clear_Activity();                           /* Drops everything in flight */
+
+    int Num_Inputs() const { return Inputs.size(); }
+    int Num_Outputs() const { return Outputs.size(); }
+    int Output_Node(int output) const { return Outputs[output]; }
+    const std::vector <int> &Output_Times(int output) const { return Times[output]; }
+
+    bool Run_Time_Inclusive = false;                         /* From the proc_params */
+
+  protected:
+    struct Charge_Event {
+      int32_t To;
+      int32_t Weight;
+    };
+    struct Input_Event {
+      int64_t Time;                                          /* Absolute */
+      int32_t Node;
+      int32_t Charge;
+    };
+
+    void Fatal(const char *fmt, ...) __attribute__ ((format (printf, 2, 3), noreturn));
+    void Read_Params(const char *empty_network);
+    void Load_IO(const SNN_Network &net);                   /* Inputs, outputs and the clock */
+    void Sort_Pending();
+    void Fire(int node, int64_t t);
+
+    /* The proc_params. */
+
+    bool Threshold_Inclusive = true;
+    double Spike_Value_Factor = 1;
+    int32_t Min_Potential = 0;
+
+    /* The network: thresholds (already adjusted for Threshold_Inclusive, so a neuron fires
+       when its charge is >= Threshold), and the synapses in CSR form, as in SNN_Network. */
+
+    std::vector <int32_t> Threshold;
+    std::vector <uint64_t> Edge_Start;
+    std::vector <int32_t> To, Weight, Delay;
+    std::vector <int> Inputs, Outputs;
+    std::vector <int> Output_Index;                          /* Per node, or -1 */
+
+    /* The state. */
+
+    std::vector < std::vector <Charge_Event> > Wheel;
+    uint64_t In_Flight = 0;                                  /* Events in the wheel */
+    std::vector <Input_Event> Pending;                       /* Input spikes for the next Run() */
+    std::vector <int32_t> Charge;
+    std::vector <int64_t> Stamp;                             /* When Charge was last set */
+    std::vector <int> Touched;                               /* The neurons charged this timestep */
+    int64_t Now = 0;                                         /* When the next Run() starts */
+    int64_t Run_Start = 0;
+    std::vector < std::vector <int> > Times;                 /* Per output, from the last Run() */
+};
+
+/* ------------------------------------------------------------ */
+
+inline void SNN_Simulator::Fatal(const char *fmt, ...)
+{
+  va_list ap;
+
+  fprintf(stderr, "SNN_Simulator: ");
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+/* The text of an empty RISP network with the given proc_params, laid out like
+   networks/empty-risp-1-7.txt, for bin/snn_sim's EMPTYNET and for bin/dbscan_pipeline.  The
+   parameters that the simulator reads get RISP's defaults if they aren't set. */
+
+inline std::string SNN_Empty_Network(const std::string &params)
+{
+  JSON_Skimmer j;
+  std::map <std::string, std::string> p;
+  std::map <std::string, std::string>::iterator pit;
+  std::string k, s;
+  size_t i;
+  char buf[1000];
+  const char *need[] = { "min_threshold", "max_threshold", "min_weight", "max_weight", "max_delay", NULL };
+
+  j.Text = params;
+  j.What = "RISP parameters";
+  for (i = j.First(0); i != std::string::npos; i = j.Next(j.Skip_Value(i), '}')) {
+    i = j.Member(i, k);
+    p[k] = j.Text.substr(i, j.Skip_Value(i) - i);
+  }
+  for (i = 0; need[i] != NULL; i++) {
+    if (p.find(need[i]) == p.end()) j.Fatal("%s has to be set", need[i]);
+  }
+  if (p.find("fire_like_ravens") == p.end()) p["fire_like_ravens"] = "false";
+  if (p.find("run_time_inclusive") == p.end()) p["run_time_inclusive"] = "false";
+  if (p.find("threshold_inclusive") == p.end()) p["threshold_inclusive"] = "true";
+  if (p.find("spike_value_factor") == p.end()) p["spike_value_factor"] = p["max_weight"];
+
+  s = "{ \"Properties\":\n";
+  s += "  { \"node_properties\": [\n";
+  snprintf(buf, sizeof(buf), "      { \"name\":\"Threshold\", \"type\":73, \"index\":0, \"size\":1, "
+           "\"min_value\":%s, \"max_value\":%s }],\n",
+           p["min_threshold"].c_str(), p["max_threshold"].c_str());
+  s += buf;
+  s += "    \"edge_properties\": [\n";
+  snprintf(buf, sizeof(buf), "      { \"name\":\"Delay\", \"type\":73, \"index\":1, \"size\":1, "
+           "\"min_value\":1.0, \"max_value\":%s },\n", p["max_delay"].c_str());
+  s += buf;
+  snprintf(buf, sizeof(buf), "      { \"name\":\"Weight\", \"type\":73, \"index\":0, \"size\":1, "
+           "\"min_value\":%s, \"max_value\":%s }],\n",
+           p["min_weight"].c_str(), p["max_weight"].c_str());
+  s += buf;
+  s += "    \"network_properties\": [] },\n";
+  s += " \"Nodes\": [],\n \"Edges\": [],\n \"Inputs\": [],\n \"Outputs\": [],\n";
+  s += " \"Network_Values\": [],\n";
+  s += " \"Associated_Data\":\n";
+  s += "   { \"other\": {\"proc_name\":\"risp\"},\n";
+  s += "     \"proc_params\": \n";
+  for (pit = p.begin(); pit != p.end(); pit++) {
+    s += (pit == p.begin()) ? "      { " : "        ";
+    s += "\"" + pit->first + "\": " + pit->second;
+    s += (std::next(pit) == p.end()) ? "}}}\n" : ",\n";
+  }
+  return s;
+}
+
+/* Find the proc_params in the empty network's Associated_Data, and make sure that this is
+   the RISP that we simulate. */
+
+inline void SNN_Simulator::Read_Params(const char *empty_network)
+{
+  JSON_Skimmer j;
+  std::string k, s;
+  size_t i, v, p, params;
+  bool discrete, leak_all;
+  double d;
+
+  j.Text = empty_network;
+  j.What = "network (Associated_Data)";
+  params = std::string::npos;
+  for (i = j.First(0); i != std::string::npos; i = j.Next(j.Skip_Value(v), '}')) {
+    v = j.Member(i, k);
+    if (k == "Associated_Data") {
+      for (p = j.First(v); p != std::string::npos; p = j.Next(j.Skip_Value(p), '}')) {
+        p = j.Member(p, k);
+        if (k == "proc_params") params = p;
+      }
+    }
+  }
+  if (params == std::string::npos) j.Fatal("there are no proc_params");
+
+  discrete = false;
+  leak_all = false;
+  for (p = j.First(params); p != std::string::npos; p = j.Next(j.Skip_Value(p), '}')) {
+    p = j.Member(p, k);
+    s = j.Text.substr(p, j.Skip_Value(p) - p);
+    if (k == "discrete") discrete = (s == "true");
+    if (k == "leak_mode") leak_all = (j.String(p) == "all");
+    if (k == "threshold_inclusive") Threshold_Inclusive = (s == "true");
+    if (k == "run_time_inclusive") Run_Time_Inclusive = (s == "true");
+    if (k == "spike_value_factor") Spike_Value_Factor = j.Number(p);
+    if (k == "min_potential") {
+      d = j.Number(p);
+      if (d != floor(d)) Fatal("min_potential has to be an integer");
+      Min_Potential = d;
+    }
+    if ((k == "fire_like_ravens" || k == "inputs_from_weights") && s != "false") {
+      Fatal("%s isn't supported", k.c_str());
+    }
+  }
+  if (!discrete) Fatal("the network has to be discrete");
+  if (!leak_all) Fatal("leak_mode has to be \"all\"");
+}
+
+inline void SNN_Simulator::Load(const SNN_Network &net)
+{
+  uint64_t i, e;
+  int32_t max_delay;
+  float f;
+
+  Read_Params(net.Empty_Network);
+
+  Threshold.resize(net.Nodes);
+  for (i = 0; i < net.Nodes; i++) {
+    f = net.Threshold[i];
+    if (f != floorf(f)) Fatal("node %llu: the threshold has to be an integer", (unsigned long long) i);
+    Threshold[i] = (Threshold_Inclusive) ? f : f + 1;
+  }
+
+  Edge_Start.assign(net.Edge_Start, net.Edge_Start + net.Nodes + 1);
+  To.resize(net.Edges);
+  Weight.resize(net.Edges);
+  Delay.resize(net.Edges);
+  max_delay = 1;
+  for (i = 0; i < net.Nodes; i++) {
+    for (e = Edge_Start[i]; e < Edge_Start[i+1]; e++) {
+      f = net.Synapses[e].Weight;
+      if (f != floorf(f)) {
+        Fatal("edge %llu -> %d: the weight has to be an integer", (unsigned long long) i, net.Synapses[e].To);
+      }
+      if (net.Synapses[e].Delay < 1) {
+        Fatal("edge %llu -> %d: the delay has to be >= 1", (unsigned long long) i, net.Synapses[e].To);
+      }
+      To[e] = net.Synapses[e].To;
+      Weight[e] = f;
+      Delay[e] = net.Synapses[e].Delay;
+      max_delay = std::max(max_delay, Delay[e]);
+    }
+  }
+
+  Load_IO(net);
+  Wheel.clear();
+  Wheel.resize(max_delay + 1);
+  Charge.assign(net.Nodes, 0);
+  Stamp.assign(net.Nodes, -1);
+  Touched.clear();
+  Clear_Activity();
+}
+
+inline void SNN_Simulator::Load_IO(const SNN_Network &net)
+{
+  uint64_t i;
+
+  Inputs.assign(net.Inputs, net.Inputs + net.Num_Inputs);
+  Outputs.assign(net.Outputs, net.Outputs + net.Num_Outputs);
+  Output_Index.assign(net.Nodes, -1);
+  for (i = 0; i < net.Num_Outputs; i++) Output_Index[Outputs[i]] = i;
+  Times.clear();
+  Times.resize(net.Num_Outputs);
+  Now = 0;
+  Run_Start = 0;
+}
+
+inline void SNN_Simulator::Clear_Activity()
+{
+  size_t i;
+
+  for (i = 0; i < Wheel.size(); i++) Wheel[i].clear();
+  In_Flight = 0;
+  Pending.clear();
+}
+
+inline void SNN_Simulator::Apply_Spike(int input, int time, double value)
+{
+  Input_Event ie;
+  double c;
+
+  if (input < 0 || input >= (int) Inputs.size()) Fatal("input %d doesn't exist", input);
+  if (time < 0) Fatal("input spike times have to be >= 0");
+  c = value * Spike_Value_Factor;
+  if (c != floor(c)) Fatal("input %d: the spike's charge (%lg) has to be an integer", input, c);
+  ie.Time = Now + time;
+  ie.Node = Inputs[input];
+  ie.Charge = c;
+  Pending.push_back(ie);
+}
+
+/* The inputs are sorted by time, and Run() leaves the ones past its end for the next run. */
+
+inline void SNN_Simulator::Sort_Pending()
+{
+  std::stable_sort(Pending.begin(), Pending.end(),
+                   [](const Input_Event &a, const Input_Event &b) { return a.Time < b.Time; });
+}
+
+inline void SNN_Simulator::Fire(int node, int64_t t)
+{
+  uint64_t e;
+  Charge_Event ce;
+
+  if (Output_Index[node] >= 0) Times[Output_Index[node]].push_back(t - Run_Start);
+  for (e = Edge_Start[node]; e < Edge_Start[node+1]; e++) {
+    ce.To = To[e];
+    ce.Weight = Weight[e];
+    Wheel[(t + Delay[e]) % Wheel.size()].push_back(ce);
+  }
+  In_Flight += Edge_Start[node+1] - Edge_Start[node];
+}
+
+inline void SNN_Simulator::Run(int duration)
+{
+  int64_t t, end;
+  size_t i, p, n;
+  int node;
+  std::vector <Input_Event> later;
+  std::vector <Charge_Event> *bucket;
+
+  for (i = 0; i < Times.size(); i++) Times[i].clear();
+  Run_Start = Now;
+  end = Now + duration + ((Run_Time_Inclusive) ? 1 : 0);
+
+  Sort_Pending();
+  p = 0;
+
+  for (t = Now; t < end; t++) {
+    if (In_Flight == 0) {
+      if (p == Pending.size()) break;
+      if (Pending[p].Time > t) t = std::min(Pending[p].Time, end);
+      if (t == end) break;
+    }
+
+    /* Collect the charge that arrives at t. */
+
+    bucket = &Wheel[t % Wheel.size()];
+    n = bucket->size();
+    for (i = 0; i < n; i++) {
+      node = (*bucket)[i].To;
+      if (Stamp[node] != t) {
+        Stamp[node] = t;
+        Charge[node] = 0;
+        Touched.push_back(node);
+      }
+      Charge[node] += (*bucket)[i].Weight;
+    }
+    In_Flight -= n;
+    bucket->clear();
+
+    for (; p < Pending.size() && Pending[p].Time == t; p++) {
+      node = Pending[p].Node;
+      if (Stamp[node] != t) {
+        Stamp[node] = t;
+        Charge[node] = 0;
+        Touched.push_back(node);
+      }
+      Charge[node] += Pending[p].Charge;
+    }
+
+    /* Fire the neurons that reach their thresholds.  The potential leaks away entirely
+       at the end of the timestep, so there is nothing to reset. */
+
+    for (i = 0; i < Touched.size(); i++) {
+      node = Touched[i];
+      if (std::max(Charge[node], Min_Potential) >= Threshold[node]) Fire(node, t);
+    }
+    Touched.clear();
+  }
+
+  later.assign(Pending.begin() + p, Pending.end());
+  Pending.swap(later);
+  Now = end;
+}
@@ -1,7 +1,7 @@
 #/bin/sh
 
 if [ $# -ne 7 ] && [ $# -ne 8 ]; then
-  echo 'usage: sh make_video.sh R C e e_t mp csv_event_file segment_time_length [3D_SYSTOLIC, 3D_FLAT]' >&2
+  echo 'usage: sh make_video.sh R C e e_t mp event_file(csv or aedat4) segment_time_length [3D_SYSTOLIC, 3D_FLAT]' >&2
   exit 1
 fi
 
@@ -19,10 +19,15 @@ if [ $# -eq 8 ]; then
   fs=$8
 fi
 
-pt=$fr/cpp-apps/bin/processor_tool_risp
-if [ ! -x $pt ]; then
-  echo "Making the processor tool" >&2
-  ( cd $fr/cpp-apps ; make app=processor_tool proc=risp ) >&2
+if [ "$fr" = - ]; then
+  pt=bin/snn_sim
+  if [ ! -x $pt ]; then make bin/snn_sim >&2 ; fi
+else
+  pt=$fr/cpp-apps/bin/processor_tool_risp
+  if [ ! -x $pt ]; then
+    echo "Making the processor tool" >&2
+    ( cd $fr/cpp-apps ; make app=processor_tool proc=risp ) >&2
+  fi
 fi
 
 if [ "$fs" = "3D_FLAT" ]; then
@@ -70,9 +75,9 @@ if [ "$fs" = "3D_SYSTOLIC" ]; then
 
   echo "Creating 3D Systolic network and running data through it. This will likely take some time..."
   # Apply dbscan with a systolic network for yucks
-  ./bin/3d_dbscan_systolic_full $r $c $e $e_t $mp tmp-empty.txt > tmp-network-tool-commands.txt 
-  $fr/bin/network_tool < tmp-network-tool-commands.txt > tmp-dbscan-network.txt
-  bin/create_spikes_full 3D_SYSTOLIC $e < tmp_frames.txt > tmp-input-spikes.txt
+  ./bin/3d_dbscan_systolic_full $r $c $e $e_t $mp tmp-empty.txt JSON > tmp-dbscan-network.txt 
+  if [ "$fr" = - ]; then sf=3D_SYSTOLIC_AST; else sf=3D_SYSTOLIC; fi
+  bin/create_spikes_full $sf $e < tmp_frames.txt > tmp-input-spikes.txt
   rt=$(($num_frames*($c+$e*2+4))) 
   o=OT
 
@@ -98,8 +103,7 @@ if [ "$fs" = "3D_FLAT" ]; then
 
   echo "Creating 3D Flat network and running data through it. This will likely take some time..."
   # Apply dbscan with a Flat network for yucks
-  ./bin/3d_dbscan_flat_full $r $c $e $e_t $mp tmp-empty.txt > tmp-network-tool-commands.txt 
-  $fr/bin/network_tool < tmp-network-tool-commands.txt > tmp-dbscan-network.txt
+  ./bin/3d_dbscan_flat_full $r $c $e $e_t $mp tmp-empty.txt JSON > tmp-dbscan-network.txt 
   bin/create_spikes_full 3D_FLAT < tmp_frames.txt > tmp-input-spikes.txt
   rt=$(($num_frames + 4)) 
   o=OT
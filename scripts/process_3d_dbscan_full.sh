@@ -1,5 +1,5 @@
 if [ $# -ne 6 ]; then
-  echo 'usage: sh process_3d_dbscan_full.sh epsilon epsilon_time minpoints data_file 3D_FLAT|3D_SYSTOLIC framework_dir' >&2
+  echo 'usage: sh process_3d_dbscan_full.sh epsilon epsilon_time minpoints data_file 3D_FLAT|3D_SYSTOLIC framework_dir|-' >&2
   exit 1
 fi
 
@@ -17,7 +17,10 @@ fi
 
 # Step 0 -- makes sure you have all of the right executables.
 
-if [ -f $fr/src/processor_tool.cpp ]; then
+if [ "$fr" = - ]; then
+  pt=bin/snn_sim
+  if [ ! -x $pt ]; then make bin/snn_sim >&2 ; fi
+elif [ -f $fr/src/processor_tool.cpp ]; then
   pt=$fr/bin/processor_tool_risp
   if [ ! -x $pt ]; then
     echo "Making the processor tool" >&2
@@ -33,13 +36,6 @@ fi
 
 if [ ! -x $pt ]; then exit 1; fi
 
-if [ ! -x $fr/bin/network_tool ]; then
-  echo "Making the network tool" >&2
-  ( cd $fr ; make bin/network_tool ) >&2
-fi
-
-if [ ! -x $fr/bin/network_tool ]; then exit 1; fi
-
 if [ $fs = 3D_FLAT -a ! -x bin/3d_dbscan_flat_full ]; then make bin/3d_dbscan_flat_full >&2 ; fi
 if [ $fs = 3D_SYSTOLIC -a ! -x bin/3d_dbscan_systolic_full ]; then make bin/3d_dbscan_systolic_full >&2 ; fi
 if [ ! -x bin/create_spikes_full ]; then make bin/create_spikes_full >&2 ; fi
@@ -103,16 +99,17 @@ fi
 # Next, use dbscan_flat_full to make the network
 
 if [ $fs = 3D_FLAT ]; then
-  bin/3d_dbscan_flat_full $rows $cols $epsilon $epsilon_time $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/3d_dbscan_flat_full $rows $cols $epsilon $epsilon_time $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 else
-  bin/3d_dbscan_systolic_full $rows $cols $epsilon $epsilon_time $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/3d_dbscan_systolic_full $rows $cols $epsilon $epsilon_time $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 fi
 
-$fr/bin/network_tool < tmp-network-tool-commands.txt > tmp-dbscan-network.txt
-
-# And use create_spikes to make the input spikes:
+# And use create_spikes to make the input spikes.  bin/snn_sim reads the compact AST form
+# of the rasters.
 if [ $fs = 3D_FLAT ]; then
   bin/create_spikes_full $fs < $datafile > tmp-input-spikes.txt
+elif [ "$fr" = - ]; then
+  bin/create_spikes_full 3D_SYSTOLIC_AST $epsilon < $datafile > tmp-input-spikes.txt
 else
   bin/create_spikes_full $fs $epsilon < $datafile > tmp-input-spikes.txt
 fi
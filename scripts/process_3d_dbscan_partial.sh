@@ -1,5 +1,5 @@
 if [ $# -ne 10 ]; then
-  echo 'usage: sh process_3d_dbscan_partial.sh epsilon epsilon_time minpoints data_file I_R I_C sr sc 3D_FLAT|3D_SYSTOLIC|3D_FLAT_STREAM|3D_SYSTOLIC_STREAM|3D_SYSTOLIC_STREAM_AS framework_dir' >&2
+  echo 'usage: sh process_3d_dbscan_partial.sh epsilon epsilon_time minpoints data_file I_R I_C sr sc 3D_FLAT|3D_SYSTOLIC|3D_FLAT_STREAM|3D_SYSTOLIC_STREAM|3D_SYSTOLIC_STREAM_AS framework_dir|-' >&2
   exit 1
 fi
 
@@ -12,7 +12,7 @@ ic=$6
 sr=$7
 sc=$8
 fs=$9
-#fr=$10
+fr=${10}
 
 if [ "$fs" != 3D_FLAT -a "$fs" != 3D_SYSTOLIC -a "$fs" != 3D_FLAT_STREAM -a "$fs" != 3D_SYSTOLIC_STREAM -a "$fs" != 3D_SYSTOLIC_STREAM_AS ]; then
   echo "Fifth parameter must be 3D_FLAT, 3D_SYSTOLIC, 3D_FLAT_STREAM, 3D_SYSTOLIC_STREAM, or 3D_SYSTOLIC_STREAM_AS " >&2
@@ -21,7 +21,10 @@ fi
 
 # Step 0 -- makes sure you have all of the right executables.
 
-if [ -f $fr/src/processor_tool.cpp ]; then
+if [ "$fr" = - ]; then
+  pt=bin/snn_sim
+  if [ ! -x $pt ]; then make bin/snn_sim >&2 ; fi
+elif [ -f $fr/src/processor_tool.cpp ]; then
   pt=$fr/bin/processor_tool_risp
   if [ ! -x $pt ]; then
     echo "Making the processor tool" >&2
@@ -37,13 +40,6 @@ fi
 
 if [ ! -x $pt ]; then exit 1; fi
 
-if [ ! -x $fr/bin/network_tool ]; then
-  echo "Making the network tool" >&2
-  ( cd $fr ; make bin/network_tool ) >&2
-fi
-
-if [ ! -x $fr/bin/network_tool ]; then exit 1; fi
-
 if [ $fs = 3D_FLAT -a ! -x bin/3d_dbscan_flat_partial ]; then make bin/3d_dbscan_flat_partial >&2 ; fi
 if [ $fs = 3D_SYSTOLIC -a ! -x bin/3d_dbscan_systolic_partial ]; then make bin/3d_dbscan_systolic_partial >&2 ; fi
 if [ $fs = 3D_FLAT_STREAM -a ! -x bin/3d_dbscan_flat_partial_stream ]; then make bin/3d_dbscan_flat_partial_stream >&2 ; fi
@@ -145,19 +141,20 @@ fi
 # Next, use dbscan_flat_partial to make the network
 
 if [ $fs = 3D_FLAT ]; then 
-  bin/3d_dbscan_flat_partial $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/3d_dbscan_flat_partial $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 elif [ $fs = 3D_SYSTOLIC ]; then
-  bin/3d_dbscan_systolic_partial $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/3d_dbscan_systolic_partial $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 elif [ $fs = 3D_FLAT_STREAM ]; then 
-  bin/3d_dbscan_flat_partial_stream $rows $cols $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/3d_dbscan_flat_partial_stream $rows $cols $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 elif [ $fs = 3D_SYSTOLIC_STREAM -o $fs = 3D_SYSTOLIC_STREAM_AS ]; then
-  bin/3d_dbscan_systolic_partial_stream $rows $cols $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/3d_dbscan_systolic_partial_stream $rows $cols $ir $ic $epsilon $epsilon_time $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 fi
 
-$fr/bin/network_tool < tmp-network-tool-commands.txt > tmp-dbscan-network.txt
-
-# And use create_spikes to make the input spikes:
-bin/create_spikes_partial $ir $ic $sr $sc $epsilon $fs < $datafile > tmp-input-spikes.txt
+# And use create_spikes to make the input spikes.  bin/snn_sim reads the compact AST form
+# of the rasters.
+sf=$fs
+if [ "$fr" = - ] && [ $fs = 3D_SYSTOLIC -o $fs = 3D_SYSTOLIC_STREAM ]; then sf=${fs}_AST; fi
+bin/create_spikes_partial $ir $ic $sr $sc $epsilon $sf < $datafile > tmp-input-spikes.txt
 
 
 # Calculate the run times and specify the output method:
@@ -176,6 +173,28 @@ elif [ $fs = 3D_SYSTOLIC_STREAM -o $fs = 3D_SYSTOLIC_STREAM_AS ]; then
   o=OT
 fi
 
+# With bin/snn_sim, the STREAM modes run a frame at a time, and after each frame, OE prints
+# its output spikes in time order, so the decoder (with EVENTS) can print each frame as
+# soon as it's done, rather than at the end.
+
+if [ "$fr" = - ] && [ $fs = 3D_FLAT_STREAM -o $fs = 3D_SYSTOLIC_STREAM -o $fs = 3D_SYSTOLIC_STREAM_AS ]; then
+  if [ $fs = 3D_FLAT_STREAM ]; then
+    fl=$(($rows_div_ir * $cols_div_ic))
+  else
+    fl=$(($rows_div_ir * ($cols+4*$epsilon)))
+  fi
+  ( echo ML tmp-dbscan-network.txt ; cat tmp-input-spikes.txt
+    i=0
+    while [ $i -lt $num_frames ]; do echo RUN $fl ; echo OE ; i=$(($i+1)) ; done
+    echo RUN $(($rt - $num_frames * $fl)) ; echo OE ) | $pt | tee tmp-ptool-output.txt |
+  if [ $fs = 3D_FLAT_STREAM ]; then
+    bin/3d_output_flat_partial_stream $rows $cols $ir $ic $epsilon $num_frames EVENTS
+  else
+    bin/3d_output_systolic_partial_stream $rows $cols $ir $ic $epsilon $num_frames EVENTS
+  fi
+  exit 0
+fi
+
 # Now, run the processor tool and grab the outputs.
 
 ( echo ML tmp-dbscan-network.txt ; cat tmp-input-spikes.txt ; echo RUN $rt ; echo $o ) | $pt > tmp-ptool-output.txt
@@ -1,5 +1,5 @@
 if [ $# -ne 5 ]; then
-  echo 'usage: sh process_dbscan_full.sh epsilon minpoints data_file FLAT|SYSTOLIC framework_dir' >&2
+  echo 'usage: sh process_dbscan_full.sh epsilon minpoints data_file FLAT|SYSTOLIC framework_dir|-' >&2
   exit 1
 fi
 
@@ -16,7 +16,10 @@ fi
 
 # Step 0 -- makes sure you have all of the right executables.
 
-if [ -f $fr/src/processor_tool.cpp ]; then
+if [ "$fr" = - ]; then
+  pt=bin/snn_sim
+  if [ ! -x $pt ]; then make bin/snn_sim >&2 ; fi
+elif [ -f $fr/src/processor_tool.cpp ]; then
   pt=$fr/bin/processor_tool_risp
   if [ ! -x $pt ]; then
     echo "Making the processor tool" >&2
@@ -32,13 +35,6 @@ fi
 
 if [ ! -x $pt ]; then exit 1; fi
 
-if [ ! -x $fr/bin/network_tool ]; then
-  echo "Making the network tool" >&2
-  ( cd $fr ; make bin/network_tool ) >&2
-fi
-
-if [ ! -x $fr/bin/network_tool ]; then exit 1; fi
-
 if [ $fs = FLAT -a ! -x bin/dbscan_flat_full ]; then make bin/dbscan_flat_full >&2 ; fi
 if [ $fs = SYSTOLIC -a ! -x bin/dbscan_systolic_full ]; then make bin/dbscan_systolic_full >&2 ; fi
 if [ ! -x bin/create_spikes_full ]; then make bin/create_spikes_full >&2 ; fi
@@ -69,16 +65,17 @@ cols=$(($cols/$rows-1))
 # Next, use dbscan_flat_full to make the network
 
 if [ $fs = FLAT ]; then
-  bin/dbscan_flat_full $rows $cols $epsilon $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/dbscan_flat_full $rows $cols $epsilon $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 else
-  bin/dbscan_systolic_full $rows $epsilon $minpoints tmp-empty.txt > tmp-network-tool-commands.txt
+  bin/dbscan_systolic_full $rows $epsilon $minpoints tmp-empty.txt JSON > tmp-dbscan-network.txt
 fi
 
-$fr/bin/network_tool < tmp-network-tool-commands.txt > tmp-dbscan-network.txt
-
-# And use create_spikes to make the input spikes:
+# And use create_spikes to make the input spikes.  bin/snn_sim reads the compact AST form
+# of the rasters.
 
-bin/create_spikes_full $fs < $datafile > tmp-input-spikes.txt
+sf=$fs
+if [ "$fr" = - -a $fs = SYSTOLIC ]; then sf=SYSTOLIC_AST; fi
+bin/create_spikes_full $sf < $datafile > tmp-input-spikes.txt
 
 # Calculate the run times and specify the output method:
 
@@ -1,12 +1,40 @@
-/* This program performs 3D-DBSCAN on a series of full or partial input grid.  
+/* This program performs 3D-DBSCAN on a series of full or partial input grid.
 
-It is not very efficient. */
+The labeling is done by libdbscan (include/dbscan.hpp, src/libdbscan.cpp), which labels the
+frames one at a time with one of four engines -- LOOP, SAT, BITS or SPARSE -- whose outputs
+are identical.  See src/libdbscan.cpp for how each one works.  AUTO (the default) measures
+the fraction of cells that are On, and picks SPARSE or BITS.
+
+The frames are always packed into bits as they are read, so we never hold the text.  They
+can also be in the binary format of include/frame_file.hpp (bin/ebc_to_frames -b), which is
+recognized by its first character.
+
+With -j threads, the frames are split into chunks, which a work-stealing pool of threads
+labels in parallel.  Each chunk gets its own labeler, which first runs over the 2*e_t frames
+before the chunk, so that the cores of the chunk's first e_t frames' windows are right.  Then
+the labels are identical to the serial run.
+
+With -s, the program streams: it reads one frame at a time, labels it, prints it and flushes,
+so it only ever holds one frame of input plus the engine's last e_t+1 frames of state.  If
+data_file is "-", it reads standard input, so you can pipe bin/ebc_to_frames right into it.
+
+With -c, instead of the labels, it prints the cluster ID of each core and border in the
+I_RxI_C window, one per line: "frame row col label cluster".  The clusters are computed
+after labeling, with union-find (include/clusters.hpp), so -c can't be used with -s.
+
+Binary frames with polarity (bin/ebc_to_frames -b -p) have an ON and an OFF channel.
+Normally, an event of either polarity counts, just as if there were no polarity.  With -p,
+the two channels are labeled separately, in the same pass over the frames, each with its own
+labeler, so ON events only count ON neighbors, and OFF events only count OFF neighbors.
+Each frame's output is then the ON window, followed by the OFF window, and then the blank
+line.  With -c, the OFF labels are 'c' and 'b', and each channel numbers its own clusters. */
 
 /* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
 
 #include <string>
 #include <vector>
 #include <list>
+#include <deque>
 #include <cmath>
 #include <algorithm>
 #include <map>
@@ -14,27 +42,246 @@ It is not very efficient. */
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <mutex>
 #include <cstdio>
 #include <cstdlib>
+#include "bitgrid.hpp"
+#include "clusters.hpp"
+#include "dbscan.hpp"
+#include "frame_file.hpp"
 using namespace std;
 
 #define DEBUG 0
 
+/* ------------------------------------------------------------ */
+/* Output, and the thread pool. */
+
+/* Set s to the text of the I_RxI_C window at sr, sc of a frame's labels (RxC, row-major),
+   plus its blank line.  S is reused from frame to frame. */
+
+void Window(const string &labels, int R, int C, int ir, int ic, int sr, int sc, string &s)
+{
+  int j, k;
+
+  s.clear();
+  for (j = sr; j < sr + ir; j++) {
+    for (k = sc; k < sc + ic; k++) {
+      if (j < R && k < C) {
+        s.push_back(labels[(size_t) j*C+k]);
+      } else {
+        s.push_back('.');
+      }
+    }
+    s.push_back('\n');
+  }
+  s.push_back('\n');
+}
+
+/* Each worker thread owns a deque of chunk numbers.  It takes chunks from the front of its
+   own deque, and when that's empty, it steals from the back of the other workers' deques. */
+
+class Pool {
+  public:
+    int Frames, Chunk, Threads;
+    int Ir, Ic, Sr, Sc;
+    string Engine_Name;
+    int R, C, E, Et, Mp;
+    const vector <BitGrid> *Events;
+    vector <string> *Output;              // The window text of each frame
+    vector <string> *Labels;              // The labels of each frame, if not NULL
+    vector < deque <int> > Work;
+    vector <mutex> Locks;
+
+    void Run(int threads);
+  protected:
+    bool Next(int id, int &chunk);
+    void Worker(int id);
+    void Label(int chunk);
+};
+
+bool Pool::Next(int id, int &chunk)
+{
+  int i, v;
+
+  for (i = 0; i < Threads; i++) {
+    v = (id + i) % Threads;
+    lock_guard <mutex> l(Locks[v]);
+    if (!Work[v].empty()) {
+      if (v == id) {
+        chunk = Work[v].front();
+        Work[v].pop_front();
+      } else {
+        chunk = Work[v].back();
+        Work[v].pop_back();
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void Pool::Worker(int id)
+{
+  int chunk;
+
+  while (Next(id, chunk)) Label(chunk);
+}
+
+void Pool::Label(int chunk)
+{
+  DBSCAN dbscan(R, C, E, Et, Mp, Engine_Name);
+  string labels;
+  int a, b, i;
+
+  a = chunk * Chunk;
+  b = (a + Chunk > Frames) ? Frames : a + Chunk;
+  labels.resize((size_t) R * C);
+
+  for (i = (a - 2*Et < 0) ? 0 : a - 2*Et; i < b; i++) {
+    dbscan.Push((*Events)[i], &labels[0]);
+    if (i >= a && Labels != NULL) (*Labels)[i] = labels;
+    if (i >= a && Labels == NULL) Window(labels, R, C, Ir, Ic, Sr, Sc, (*Output)[i]);
+  }
+}
+
+void Pool::Run(int threads)
+{
+  vector <thread> workers;
+  int nchunks, i;
+
+  Threads = threads;
+  nchunks = (Frames + Chunk - 1) / Chunk;
+  Work.resize(Threads);
+  Locks = vector <mutex> (Threads);
+  for (i = 0; i < nchunks; i++) Work[(long long) i * Threads / nchunks].push_back(i);
+
+  for (i = 0; i < Threads; i++) workers.push_back(thread(&Pool::Worker, this, i));
+  for (i = 0; i < Threads; i++) workers[i].join();
+}
+
+/* Print the cluster of each core and border in the I_RxI_C window at sr, sc.  With two
+   channels, their events are merged frame by frame, ON first, and the OFF labels are lower
+   case. */
+
+void Print_Clusters(Clusters *clusters, int channels, int ir, int ic, int sr, int sc)
+{
+  size_t i[2];
+  int ch, n;
+  const Clusters::Event *ev, *e2;
+
+  for (ch = 0; ch < channels; ch++) {
+    clusters[ch].Finish();
+    i[ch] = 0;
+  }
+  while (true) {
+    ch = -1;
+    for (n = 0; n < channels; n++) {
+      if (i[n] == clusters[n].Events.size()) continue;
+      e2 = &clusters[n].Events[i[n]];
+      if (ch == -1 || e2->Frame < ev->Frame) {
+        ch = n;
+        ev = e2;
+      }
+    }
+    if (ch == -1) return;
+    i[ch]++;
+    if (ev->Row >= sr && ev->Row < sr + ir && ev->Col >= sc && ev->Col < sc + ic) {
+      printf("%d %d %d %c %d\n", ev->Frame, ev->Row, ev->Col,
+             (ch == 0) ? ev->Label : ev->Label - 'A' + 'a', ev->Cluster);
+    }
+  }
+}
+
+/* ------------------------------------------------------------ */
+/* Input */
+
+/* Read frame fc -- lines up to a blank line or the end of the input -- and pack it into frame.
+   Cols is the number of columns, or -1 for the first frame, whose first line sets it.
+   Returns false when there is nothing left to read.  If ff is open, the frame comes from
+   the binary frame file instead, and if off isn't NULL, frame gets the ON channel, and off
+   gets the OFF channel. */
+
+bool Read_Frame(istream &in, Frame_File_Reader &ff, int fc, int cols, BitGrid &frame, BitGrid *off)
+{
+  string line;
+  bool any;
+  int k;
+  size_t i;
+
+  if (ff.Rows > 0) {
+    if (!ff.Next()) return false;
+    frame.Resize(ff.Rows, ff.Cols);
+    if (off == NULL) {
+      for (i = 0; i < ff.Cells.size(); i++) frame.Set(ff.Cells[i] / ff.Cols, ff.Cells[i] % ff.Cols);
+    } else {
+      off->Resize(ff.Rows, ff.Cols);
+      for (i = 0; i < ff.On.size(); i++) frame.Set(ff.On[i] / ff.Cols, ff.On[i] % ff.Cols);
+      for (i = 0; i < ff.Off.size(); i++) off->Set(ff.Off[i] / ff.Cols, ff.Off[i] % ff.Cols);
+    }
+    return true;
+  }
+
+  any = false;
+  frame.Resize(0, (cols < 0) ? 0 : cols);
+  while (getline(in, line)) {
+    any = true;
+    if (line == "") return true;
+    if (cols < 0) {
+      cols = line.size();
+      frame.Resize(0, cols);
+    }
+    k = frame.Add_Row(line);
+    if (k != -1) {
+      fprintf(stderr, "Non-zero/one character at frame %d row %d col %d\n", fc, frame.Rows-1, k);
+      exit(1);
+    }
+    if ((int) line.size() != cols) {
+      fprintf(stderr, "Error  -- frame %d: lines %d and %d are different sizes\n", fc, frame.Rows-1, 0);
+    }
+  }
+  return any;
+}
+
+/* Frames with the wrong number of rows are padded with zeros or truncated. */
+
+void Fix_Rows(BitGrid &frame, int fc, int rows)
+{
+  if (frame.Rows != rows) {
+    fprintf(stderr, "Error -- Frames %d and %d are different sizes\n", 0, fc);
+    frame.Rows = rows;
+    frame.Bits.resize((size_t) frame.Rows * frame.Words, 0);
+  }
+}
+
+/* ------------------------------------------------------------ */
+
 int main(int argc, char **argv)
 {
   int e, et, mp, ir, ic, sr, sc, fc;
   string fn;
   ifstream fin;
-  vector <vector <string>> events;
-  string line;
-  int i, j, k, ii, jj, kk, t;
-  vector <vector <string>> ceb;
+  istream *in;
+  Frame_File_Reader ff;
+  vector <BitGrid> events[2];            // The ON and OFF channels, with -p
+  BitGrid frame[2];
+  int i, j, k, ii, jj, kk, t, ch, channels;
+  string engine_name;
+  int R, C, threads;
+  long long on;
+  bool stream, cluster, polarity;
+  DBSCAN *dbscan[2];
+  string labels[2], text, text2;
+  vector <string> output[2];
+  vector <string> all_labels[2];
+  Clusters clusters[2];
+  Pool pool;
 
-  if (argc != 9) {
-    fprintf(stderr, "usage: bin/dbscan epsilon epsilon_time minpoints data_file I_R I_C sr sc\n");
+  if (argc < 9) {
+    fprintf(stderr, "usage: bin/dbscan epsilon epsilon_time minpoints data_file I_R I_C sr sc [LOOP|SAT|BITS|SPARSE|AUTO] [-j threads] [-s] [-c] [-p]\n");
     exit(1);
   }
- 
+
   e = atoi(argv[1]);
   et = atoi(argv[2]);
   mp = atoi(argv[3]);
@@ -43,66 +290,122 @@ int main(int argc, char **argv)
   sr = atoi(argv[7]);
   sc = atoi(argv[8]);
   fn = argv[4];
+  engine_name = "AUTO";
+  threads = 1;
+  stream = false;
+  cluster = false;
+  polarity = false;
 
-  fin.clear();
-  fin.open(fn);
-  if (fin.fail()) { perror(fn.c_str()); exit(1); }
-
-  fc = 0;
-  events.resize(1);
-
-  while(getline(fin,line)){
-    if(line == ""){
-      events.push_back(vector<string>());
-      fc++;   
-    }else{
-      events[fc].push_back(line);
+  for (i = 9; i < argc; i++) {
+    if (string(argv[i]) == "-j" && i+1 < argc) {
+      threads = atoi(argv[i+1]);
+      i++;
+    } else if (string(argv[i]) == "-s") {
+      stream = true;
+    } else if (string(argv[i]) == "-c") {
+      cluster = true;
+    } else if (string(argv[i]) == "-p") {
+      polarity = true;
+    } else {
+      engine_name = argv[i];
     }
   }
 
-  // Get rid of possible empty frame at the end...
-  if (events[events.size() - 1].size() == 0) events.pop_back();
+  if (engine_name != "LOOP" && engine_name != "SAT" && engine_name != "BITS" &&
+      engine_name != "SPARSE" && engine_name != "AUTO") {
+    fprintf(stderr, "engine must be LOOP, SAT, BITS, SPARSE or AUTO\n");
+    exit(1);
+  }
+  if (threads < 1) { fprintf(stderr, "threads must be >= 1\n"); exit(1); }
+  if (stream && threads > 1) { fprintf(stderr, "-s and -j can't be used together\n"); exit(1); }
+  if (stream && cluster) { fprintf(stderr, "-s and -c can't be used together -- the clusters aren't final until the last frame\n"); exit(1); }
 
-  fin.close();
+  if (fn == "-") {
+    in = &cin;
+  } else {
+    fin.clear();
+    fin.open(fn);
+    if (fin.fail()) { perror(fn.c_str()); exit(1); }
+    in = &fin;
+  }
+  ff.Open(*in);
+  if (polarity && ff.Channels != 2) {
+    fprintf(stderr, "-p needs frames with polarity (bin/ebc_to_frames -b -p)\n");
+    exit(1);
+  }
+  channels = (polarity) ? 2 : 1;
+
+  /* When streaming, each frame is labeled and printed as soon as it is read.
+     AUTO measures the frames as they go by (see include/dbscan.hpp). */
 
-  for (i = 0; i < (int) events.size(); i++) {             // Frame
-    for (j = 0; j < (int) events[i].size(); j++) {        // Row
-      for (k = 0; k < (int) events[i][j].size(); k++){    // Col
-        if (events[i][j][k] != '0' && events[i][j][k] != '1') {
-          fprintf(stderr, "Non-zero/one character at frame %d row %d col %d\n", i, j, k);
-          exit(1);
+  if (stream) {
+    R = 0;
+    for (fc = 0; Read_Frame(*in, ff, fc, (fc == 0) ? -1 : C, frame[0], (polarity) ? &frame[1] : NULL); fc++) {
+      if (fc == 0) {
+        R = frame[0].Rows;
+        C = frame[0].Cols;
+        if (sr >= R) { fprintf(stderr, "sr too big\n"); exit(1); }
+        if (sc >= C) { fprintf(stderr, "sc too big\n"); exit(1); }
+        for (ch = 0; ch < channels; ch++) {
+          dbscan[ch] = new DBSCAN(R, C, e, et, mp, engine_name);
+          labels[ch].resize((size_t) R * C);
         }
+      } else {
+        Fix_Rows(frame[0], fc, R);
       }
-
-      if (events[i][j].size() != events[0][0].size()) {
-        fprintf(stderr, "Error  -- frame %d: lines %d and %d are different sizes\n", i, j, 0);
+      for (ch = 0; ch < channels; ch++) dbscan[ch]->Push(frame[ch], &labels[ch][0]);
+      Window(labels[0], R, C, ir, ic, sr, sc, text);
+      if (polarity) {
+        text.pop_back();
+        Window(labels[1], R, C, ir, ic, sr, sc, text2);
+        text += text2;
       }
+      fputs(text.c_str(), stdout);
+      fflush(stdout);
     }
+    if (R > 0) for (ch = 0; ch < channels; ch++) delete dbscan[ch];
+    return 0;
+  }
 
-    if (events[i].size() != events[0].size()) {
-      fprintf(stderr, "Error -- Frames %d and %d are different sizes\n",0,i);
-    }
+  /* Otherwise, read all of the frames first. */
+
+  for (ch = 0; ch < channels; ch++) if (ff.Frames > 0) events[ch].reserve(ff.Frames);
+  for (fc = 0; Read_Frame(*in, ff, fc, (fc == 0) ? -1 : events[0][0].Cols, frame[0],
+                          (polarity) ? &frame[1] : NULL); fc++) {
+    if (fc > 0) Fix_Rows(frame[0], fc, events[0][0].Rows);
+    for (ch = 0; ch < channels; ch++) events[ch].push_back(frame[ch]);
   }
+  if (events[0].size() == 0) { fprintf(stderr, "No frames in %s\n", fn.c_str()); exit(1); }
+
+  R = events[0][0].Rows;
+  C = events[0][0].Cols;
 
-  if (sr >= (int) events[0].size()) { fprintf(stderr, "sr too big\n"); exit(1); }
-  if (sc >= (int) events[0][0].size()) { fprintf(stderr, "sc too big\n"); exit(1); }
+  if (sr >= R) { fprintf(stderr, "sr too big\n"); exit(1); }
+  if (sc >= C) { fprintf(stderr, "sc too big\n"); exit(1); }
 
+  if (engine_name == "AUTO") {
+    on = 0;
+    for (ch = 0; ch < channels; ch++) {
+      for (i = 0; i < (int) events[ch].size(); i++) on += events[ch][i].Count();
+    }
+    engine_name = DBSCAN_Auto_Engine(on, (long long) R * C * events[0].size() * channels, et);
+  }
 
   if (DEBUG) {
-    for (i = 0; i < (int) events.size(); i++) {
-      for (j = 0; j < (int) events[0].size(); j++) {
-        for (k = 0; k < (int) events[0][0].size(); k++) { 
-          t = -(events[i][j][k] - '0');
+    for (i = 0; i < (int) events[0].size(); i++) {
+      for (j = 0; j < R; j++) {
+        for (k = 0; k < C; k++) {
+          t = -events[0][i].Get(j, k);
           for (ii = i-et; ii <= i; ii++) {
-            if (ii >= 0 && ii < (int) events.size()){
+            if (ii >= 0 && ii < (int) events[0].size()){
               for (jj = j-e; jj <= j+e; jj++) {
                 for (kk = k-e; kk <= k+e; kk++) {
-                  if (jj >= 0 && jj < (int) events[0].size() && kk >= 0 && kk < (int) events[0][0].size()) {
-                    t += (events[ii][jj][kk] - '0');
+                  if (jj >= 0 && jj < R && kk >= 0 && kk < C) {
+                    t += events[0][ii].Get(jj, kk);
                   }
                 }
               }
-              
+
             }
           }
           printf("%3d", t);
@@ -114,75 +417,72 @@ int main(int argc, char **argv)
 
   } //Debug
 
-  ceb = events;
-
-  for (i = 0; i < (int) events.size(); i++) {
-    for (j = 0; j < (int) events[0].size(); j++) {
-      for (k = 0; k < (int) events[0][0].size(); k++) {
-        ceb[i][j][k] = '.';
-	    }
-	  }
-  }
-
-
-    for (i = 0; i < (int) events.size(); i++) {
-      for (j = 0; j < (int) events[0].size(); j++) {
-        for (k = 0; k < (int) events[0][0].size(); k++) { 
-          if (events[i][j][k] == '1'){
-            t = 0;
-            for (ii = i-et; ii <= i; ii++) {
-              if (ii >= 0 && ii < (int) events.size()){
-                for (jj = j-e; jj <= j+e; jj++) {
-                  for (kk = k-e; kk <= k+e; kk++) {
-                    if (jj >= 0 && jj < (int) events[0].size() && kk >= 0 && kk < (int) events[0][0].size()) {
-                      t += (events[ii][jj][kk] - '0');
-                    }
-                  }
-                }
-                
-              }
-            }
-            if (t >= mp) ceb[i][j][k] = 'C';
-          }
-        }//k
-      }//j
-    } //i 
-
-
-    for (i = 0; i < (int) events.size(); i++) {
-      for (j = 0; j < (int) events[0].size(); j++) {
-        for (k = 0; k < (int) events[0][0].size(); k++) { 
-          if (events[i][j][k] == '1' && ceb[i][j][k] != 'C'){
-            for (ii = i-et; ii <= i; ii++) {
-              if (ii >= 0 && ii < (int) events.size()){
-                for (jj = j-e; jj <= j+e; jj++) {
-                  for (kk = k-e; kk <= k+e; kk++) {
-                    if (jj >= 0 && jj < (int) events[0].size() && kk >= 0 && kk < (int) events[0][0].size()) {
-                      if (ceb[ii][jj][kk] == 'C') ceb[i][j][k] = 'B';
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }//k
-      }//j
-    } //i 
+  /* Serially, we print each frame as soon as it is labeled.  In parallel, we hold
+     the window text of every frame, and print them all at the end.  With -c, the
+     labels go to the clusters instead, which are printed at the end.  With -p, each
+     channel has its own labeler (or its own run of the pool) and its own clusters. */
 
+  if (cluster) for (ch = 0; ch < channels; ch++) clusters[ch].Setup(R, C, e, et);
 
-  for (i = 0; i < (int) events.size(); i++) {
-    for (j = sr; j < sr + ir; j++) {
-      for (k = sc; k < sc + ic; k++) {
-        if (j < (int) ceb[0].size() && k < (int) ceb[0][0].size()) {
-          printf("%c",ceb[i][j][k]);
-        } else {
-          printf(".");
+  if (threads == 1) {
+    for (ch = 0; ch < channels; ch++) {
+      dbscan[ch] = new DBSCAN(R, C, e, et, mp, engine_name);
+      labels[ch].resize((size_t) R * C);
+    }
+    for (i = 0; i < (int) events[0].size(); i++) {
+      for (ch = 0; ch < channels; ch++) dbscan[ch]->Push(events[ch][i], &labels[ch][0]);
+      if (cluster) {
+        for (ch = 0; ch < channels; ch++) clusters[ch].Push(labels[ch].c_str());
+      } else {
+        Window(labels[0], R, C, ir, ic, sr, sc, text);
+        if (polarity) {
+          text.pop_back();
+          Window(labels[1], R, C, ir, ic, sr, sc, text2);
+          text += text2;
         }
+        fputs(text.c_str(), stdout);
+      }
+    }
+    for (ch = 0; ch < channels; ch++) delete dbscan[ch];
+  } else {
+    pool.Frames = events[0].size();
+    pool.Chunk = (pool.Frames + 4*threads - 1) / (4*threads);
+    if (pool.Chunk < 2*et) pool.Chunk = 2*et;
+    if (pool.Chunk < 1) pool.Chunk = 1;
+    pool.Ir = ir;
+    pool.Ic = ic;
+    pool.Sr = sr;
+    pool.Sc = sc;
+    pool.Engine_Name = engine_name;
+    pool.R = R;
+    pool.C = C;
+    pool.E = e;
+    pool.Et = et;
+    pool.Mp = mp;
+    for (ch = 0; ch < channels; ch++) {
+      if (cluster) all_labels[ch].resize(events[ch].size());
+      output[ch].resize(events[ch].size());
+      pool.Events = &events[ch];
+      pool.Output = &output[ch];
+      pool.Labels = (cluster) ? &all_labels[ch] : NULL;
+      pool.Run(threads);
+    }
+    if (cluster) {
+      for (ch = 0; ch < channels; ch++) {
+        for (i = 0; i < (int) all_labels[ch].size(); i++) clusters[ch].Push(all_labels[ch][i].c_str());
+      }
+    } else {
+      for (i = 0; i < (int) output[0].size(); i++) {
+        if (polarity) {
+          output[0][i].pop_back();
+          output[0][i] += output[1][i];
+        }
+        fputs(output[0][i].c_str(), stdout);
       }
-      printf("\n");
     }
-    printf("\n");
   }
 
+  if (cluster) Print_Clusters(clusters, channels, ir, ic, sr, sc);
+
   return 0;
 }
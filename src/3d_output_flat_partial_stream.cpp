@@ -14,21 +14,22 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include "dbscan_outputs.hpp"
 using namespace std;
 
 int main(int argc, char **argv)
 {
   string line;
-  int n, r, c, i, j, k, I_R, I_C, frames, e, R, C, row_subgroup_offset, col_subgroup_offset;
-  map < int, map < int, map < int, string > > > pts;
-  string cell, tmp;
-  istringstream iss;
-  size_t pos;
-  double time;
-  int strides_per_frame;
+  int R, C, I_R, I_C, e, frames;
+  vector <DBSCAN_Output> outs;
+  DBSCAN_Output o;
+  DBSCAN_Stream_Labels sl;
+  bool events;
+  size_t j;
+  int t;
 
-  if (argc != 7) {
-    fprintf(stderr, "usage: bin/output_flat_partial R C I_R I_C e frames\n");
+  if (argc != 7 && !(argc == 8 && string(argv[7]) == "EVENTS")) {
+    fprintf(stderr, "usage: bin/output_flat_partial R C I_R I_C e frames [EVENTS]\n");
     exit(1);
   }
   R = atoi(argv[1]);
@@ -37,63 +38,34 @@ int main(int argc, char **argv)
   I_C = atoi(argv[4]);
   e = atoi(argv[5]);
   frames = atoi(argv[6]);
+  events = (argc == 8);
 
-  strides_per_frame = ceil(R * 1.0 / I_R) * ceil(C * 1.0 / I_C); 
-
-  while (getline(cin, line)) {
-
-    if (sscanf(line.c_str(), "node %d(Border[%d][%d]) spike times:", 
-        &n, &r, &c) == 3) {
-
-      pos = line.find("times:");
-      line = line.substr(pos + 6);
-      if (line.length() > 1) {
-        line = line.substr(1);
-        iss.str(line);
-        while(iss >> time) {
-          row_subgroup_offset = (((int)time - 4) % strides_per_frame) / (int)ceil(C * 1.0 / I_C) * I_R; 
-          col_subgroup_offset = (((int)time - 4) % strides_per_frame) % (int)ceil(C * 1.0 / I_C) * I_C; 
-          pts[((int)time - 4) / strides_per_frame][row_subgroup_offset + r - 2 * e][col_subgroup_offset + c - 2 * e] = "B";
-        }
-        iss.clear();
+  /* With EVENTS, the input is bin/snn_sim's OE output, and each frame is printed as soon as
+     a "time" line says that it's done. */
 
+  if (events) {
+    sl.Flat(R, C, I_R, I_C, e);
+    while (getline(cin, line)) {
+      if (DBSCAN_Read_Output(line, o)) {
+        for (j = 0; j < o.Times.size(); j++) sl.Add(o.Cell, o.Row, o.Col, o.Times[j], o.Node);
+      } else if (sscanf(line.c_str(), "time %d", &t) == 1) {
+        sl.Flush(t, frames);
+      } else {
+        printf("Unknown line: %s\n", line.c_str());
       }
-    } else if (sscanf(line.c_str(), "node %d(Core[%d][%d]) spike times:", 
-        &n, &r, &c) == 3) {
-
-      pos = line.find("times:");
-      line = line.substr(pos + 6);
-      if (line.length() > 1){
-        line = line.substr(1);
-        iss.str(line);
-        while(iss >> time) {
-          row_subgroup_offset = (((int)time - 2) % strides_per_frame) / (int)ceil(C * 1.0 / I_C) * I_R; 
-          col_subgroup_offset = (((int)time - 2) % strides_per_frame) % (int)ceil(C * 1.0 / I_C) * I_C;
-          pts[((int)time - 2) / strides_per_frame][row_subgroup_offset + r - 2 * e][col_subgroup_offset + c - 2 * e] = "C";
-        }
-        iss.clear();
-      }
-
-    } else {
-      printf("Unknown line: %s\n", line.c_str());
     }
-
+    sl.Finish(frames);
+    return 0;
   }
 
-  for(i = 0; i < frames; i++) {
-    for(j = 0; j < R; j++) {
-      for(k = 0; k < C; k++){
-        if (pts[i][j][k] != "") {
-          printf("%s",pts[i][j][k].c_str());
-        } else {
-          printf(".");
-        }
-      }
-      printf("\n");
+  while (getline(cin, line)) {
+    if (DBSCAN_Read_Output(line, o)) {
+      outs.push_back(o);
+    } else {
+      printf("Unknown line: %s\n", line.c_str());
     }
-    printf("\n");
   }
 
+  DBSCAN_Output_3D_Flat_Partial_Stream(outs, R, C, I_R, I_C, e, frames);
   return 0;
-  
 }
@@ -14,17 +14,15 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include "dbscan_outputs.hpp"
 using namespace std;
 
 int main(int argc, char **argv)
 {
-  string line, w;
-  int n, r, c, C, R, e, sc, i, j, k, ft, frames, frame_rt;
-  map < int, map < int, map < int, string > > > pts;
-  istringstream iss;
-  size_t pos;
-  double time;
-  string cell;
+  string line;
+  int e, R, C, frames;
+  vector <DBSCAN_Output> outs;
+  DBSCAN_Output o;
 
   if (argc != 5) {
     fprintf(stderr, "usage: bin/output_systolic_full e R C frames\n");
@@ -36,69 +34,14 @@ int main(int argc, char **argv)
   C = atoi(argv[3]);
   frames = atoi(argv[4]);
 
-  frame_rt = C + 2 * e + 4;
-
   while (getline(cin, line)) {
-
-    if (sscanf(line.c_str(), "node %d(Border[%d][%d]) spike times:", 
-        &n, &r, &c) == 3) {
-
-      sc = e*2+4; 
-
-      pos = line.find("times:");
-      line = line.substr(pos + 6);
-
-      if (line.length() > 1) {
-        line = line.substr(1);
-        iss.str(line);
-        while(iss >> time) {
-          //printf("Adding: 'B' event at %f: %d %d\n",time - 4,r,c);
-          ft = (int)time % frame_rt - sc;
-          pts[time / frame_rt][r][ft] = "B";
-        }
-        iss.clear();
-
-      }
-    } else if (sscanf(line.c_str(), "node %d(Core[%d][%d]) spike times:", 
-        &n, &r, &c) == 3) {
-
-      sc = e+2; 
-
-      pos = line.find("times:");
-      line = line.substr(pos + 6);
-
-      if (line.length() > 1){
-        line = line.substr(1);
-        iss.str(line);
-        while(iss >> time) {
-          //printf("Adding: 'C' event at %f: %d %d\n",time - 2,r,c);
-          ft = (int)time % frame_rt - sc;
-          pts[time / frame_rt][r][ft] = "C";
-        }
-        iss.clear();
-      }
-
+    if (DBSCAN_Read_Output(line, o)) {
+      outs.push_back(o);
     } else {
       printf("Unknown line: %s\n", line.c_str());
     }
-
-  }
-
-
-  for(i = 0; i < frames; i++) {
-    for(j = 0; j < R; j++) {
-      for(k = 0; k < C; k++){
-        if (pts[i][j][k] != "") {
-          printf("%s",pts[i][j][k].c_str());
-        } else {
-          printf(".");
-        }
-      }
-      printf("\n");
-    }
-    printf("\n");
   }
 
+  DBSCAN_Output_3D_Systolic_Full(outs, e, R, C, frames);
   return 0;
-  
 }
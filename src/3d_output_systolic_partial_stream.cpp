@@ -16,21 +16,22 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include "dbscan_outputs.hpp"
 using namespace std;
 
 int main(int argc, char **argv)
 {
-  string line, w;
-  int n, r, c, I_C, I_R, e, i, j, k, frames, frame_rt, R, C, num_row_subgroups;
-  int c_time, b_time, frame, col, row;
-  map < int, map < int, map < int, string > > > pts;
-  istringstream iss;
-  size_t pos;
-  double time;
-  string cell;
-
-  if (argc != 7) {
-    fprintf(stderr, "usage: bin/output_systolic_partial_stream R C I_R I_C e frames\n");
+  string line;
+  int R, C, I_R, I_C, e, frames;
+  vector <DBSCAN_Output> outs;
+  DBSCAN_Output o;
+  DBSCAN_Stream_Labels sl;
+  bool events;
+  size_t j;
+  int t;
+
+  if (argc != 7 && !(argc == 8 && string(argv[7]) == "EVENTS")) {
+    fprintf(stderr, "usage: bin/output_systolic_partial_stream R C I_R I_C e frames [EVENTS]\n");
     exit(1);
   }
 
@@ -40,75 +41,36 @@ int main(int argc, char **argv)
   I_C = atoi(argv[4]);
   e = atoi(argv[5]);
   frames = atoi(argv[6]);
+  events = (argc == 8);
 
-
-  num_row_subgroups = ceil(R * 1.0 / I_R);
-  frame_rt = num_row_subgroups * (C + 4 * e); 
   (void)I_C;
 
-  while (getline(cin, line)) {
-
-    if (sscanf(line.c_str(), "node %d(Border[%d][%d]) spike times:", 
-        &n, &r, &c) == 3) {
-
-      pos = line.find("times:");
-      line = line.substr(pos + 6);
-
-      if (line.length() > 1) {
-        line = line.substr(1);
-        iss.str(line);
-        while(iss >> time) {
-          b_time = time - 4 * e - 4; //I cannot intuit why this is this way..looked at 3d_output_systolic_partial.cpp for inspiration..
-          frame = b_time / frame_rt;
-          col = b_time % (C + 4 * e);
-          row = (((b_time / (C + 4 * e)) % num_row_subgroups) * I_R) + (r - 2 * e);
-          pts[frame][row][col] = "B";
-          //printf("Border event: Frame %d Row %d Col %d\n",b_frame,b_row,b_col);
-        }
-        iss.clear();
-
-      }
-    } else if (sscanf(line.c_str(), "node %d(Core[%d][%d]) spike times:", 
-        &n, &r, &c) == 3) {
-
-      pos = line.find("times:");
-      line = line.substr(pos + 6);
-
-      if (line.length() > 1){
-        line = line.substr(1);
-        iss.str(line);
-        while(iss >> time) {
-          c_time = time - 3 * e - 2; //I cannot intuit why this is this way..looked at 3d_output_systolic_partial.cpp for inspiration..
-          frame = c_time / frame_rt;
-          col = c_time % (C + 4 * e);
-          row = (((c_time / (C + 4 * e)) % num_row_subgroups) * I_R) + (r - 2 * e);
-          pts[frame][row][col] = "C";
-          //printf("Core event: Frame %d Row %d Col %d\n",c_frame,c_row,c_col);
-        }
-        iss.clear();
+  /* With EVENTS, the input is bin/snn_sim's OE output, and each frame is printed as soon as
+     a "time" line says that it's done. */
+
+  if (events) {
+    sl.Systolic(R, C, I_R, e);
+    while (getline(cin, line)) {
+      if (DBSCAN_Read_Output(line, o)) {
+        for (j = 0; j < o.Times.size(); j++) sl.Add(o.Cell, o.Row, o.Col, o.Times[j], o.Node);
+      } else if (sscanf(line.c_str(), "time %d", &t) == 1) {
+        sl.Flush(t, frames);
+      } else {
+        printf("Unknown line: %s\n", line.c_str());
       }
-
-    } else {
-      printf("Unknown line: %s\n", line.c_str());
     }
-
+    sl.Finish(frames);
+    return 0;
   }
 
-
-  for(i = 0; i < frames; i++) {
-    for(j = 0; j < R; j++) {
-      for(k = 0; k < C; k++){
-        if (pts[i][j][k] != "") {
-          printf("%s",pts[i][j][k].c_str());
-        } else {
-          printf(".");
-        }
-      }
-      printf("\n");
+  while (getline(cin, line)) {
+    if (DBSCAN_Read_Output(line, o)) {
+      outs.push_back(o);
+    } else {
+      printf("Unknown line: %s\n", line.c_str());
     }
-    printf("\n");
   }
 
+  DBSCAN_Output_3D_Systolic_Partial_Stream(outs, R, C, I_R, e, frames);
   return 0;
-  
 }
@@ -56,14 +56,20 @@ int main()
   printf("echo e=%d e_t=%d minPts=%d R=%d C=%d Frames=%d\n", e, e_t, mp, r, c, frames);
   printf("sh scripts/process_3d_dbscan_full.sh %d %d %d tmp-data.txt 3D_FLAT $fr > %s\n", 
             e, e_t, mp, "tmp-o1.txt");
-  printf("( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'\n");
+  printf("if [ \"$fr\" != - ]; then ( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'; fi\n");
   printf("sh scripts/process_3d_dbscan_full.sh %d %d %d tmp-data.txt 3D_SYSTOLIC $fr > %s\n", 
             e, e_t, mp, "tmp-o2.txt");
-  printf("( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'\n");
-  printf("bin/3d_dbscan %d %d %d tmp-data.txt %d %d %d %d > tmp-o3.txt\n", e, e_t, mp, r, c, 0, 0);
+  printf("if [ \"$fr\" != - ]; then ( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'; fi\n");
+  printf("bin/3d_dbscan %d %d %d tmp-data.txt %d %d %d %d LOOP > tmp-o3.txt\n", e, e_t, mp, r, c, 0, 0);
+  printf("bin/3d_dbscan %d %d %d tmp-data.txt %d %d %d %d SAT > tmp-o4.txt\n", e, e_t, mp, r, c, 0, 0);
+  printf("bin/3d_dbscan %d %d %d tmp-data.txt %d %d %d %d BITS > tmp-o5.txt\n", e, e_t, mp, r, c, 0, 0);
+  printf("bin/3d_dbscan %d %d %d tmp-data.txt %d %d %d %d SPARSE > tmp-o6.txt\n", e, e_t, mp, r, c, 0, 0);
   printf("d1=`diff tmp-o1.txt tmp-o2.txt | wc | awk '{ print $1 }'`\n");
   printf("d2=`diff tmp-o1.txt tmp-o3.txt | wc | awk '{ print $1 }'`\n");
-  printf("if [ $d1 = 0 -a $d2 = 0 ]; then echo ok; else echo no; fi\n");
+  printf("d3=`diff tmp-o1.txt tmp-o4.txt | wc | awk '{ print $1 }'`\n");
+  printf("d4=`diff tmp-o1.txt tmp-o5.txt | wc | awk '{ print $1 }'`\n");
+  printf("d5=`diff tmp-o1.txt tmp-o6.txt | wc | awk '{ print $1 }'`\n");
+  printf("if [ $d1 = 0 -a $d2 = 0 -a $d3 = 0 -a $d4 = 0 -a $d5 = 0 ]; then echo ok; else echo no; fi\n");
 
   return 0;
 }
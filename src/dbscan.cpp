@@ -1,4 +1,16 @@
-/* This program performs DBSCAN on a full or partial input grid.  It is not very efficient. */
+/* This program performs DBSCAN on a full or partial input grid.  The labeling is done by
+   libdbscan (include/dbscan.hpp), with epsilon_time = 0.  By default, it uses LOOP, which is
+   not very efficient: each On event counts its neighbors with a loop over the whole
+   (2e+1)x(2e+1) window.  If you give it the optional SAT argument, then it builds a
+   summed-area table (2D prefix sum) of the events, and each window count becomes four lookups.
+   If you give it BITS, then it packs the events 64 to a word (include/bitgrid.hpp), and counts
+   with bit-sliced adders and shifted OR's, which work on 64 columns at a time.  SPARSE only
+   visits the events, and AUTO picks SPARSE or BITS from the fraction of events that are On.
+   The output is identical.
+
+   With -c, instead of the labels, it prints the cluster ID of each core and border in the
+   I_RxI_C window, one per line: "row col label cluster".  The clusters are computed from
+   the labels with union-find (include/clusters.hpp). */
 
 /* Charles P. Rizzo, James S. Plank, University of Tennessee, 2024 */
 
@@ -14,6 +26,9 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include "bitgrid.hpp"
+#include "clusters.hpp"
+#include "dbscan.hpp"
 using namespace std;
 
 #define DEBUG 0
@@ -23,16 +38,22 @@ int main(int argc, char **argv)
   int e, mp, ir, ic, sr, sc;
   string fn;
   ifstream fin;
-  vector <string> events;
+  BitGrid events;             // The events, packed as we read them, so we never hold the text
   string line;
   int i, j, ii, jj, t;
-  vector <string> ceb;
-
-  if (argc != 8) {
-    fprintf(stderr, "usage: bin/dbscan epsilon minpoints data_file I_R I_C sr sc\n");
+  string labels;
+  string engine;
+  int R, C;
+  size_t w;
+  bool cluster;
+  Clusters clusters;
+  const Clusters::Event *ev;
+
+  if (argc < 8) {
+    fprintf(stderr, "usage: bin/dbscan epsilon minpoints data_file I_R I_C sr sc [LOOP|SAT|BITS|SPARSE|AUTO] [-c]\n");
     exit(1);
   }
- 
+
   e = atoi(argv[1]);
   mp = atoi(argv[2]);
   ir = atoi(argv[4]);
@@ -40,38 +61,50 @@ int main(int argc, char **argv)
   sr = atoi(argv[6]);
   sc = atoi(argv[7]);
   fn = argv[3];
+  engine = "LOOP";
+  cluster = false;
+  for (i = 8; i < argc; i++) {
+    if (string(argv[i]) == "-c") {
+      cluster = true;
+    } else {
+      engine = argv[i];
+    }
+  }
+  if (engine != "LOOP" && engine != "SAT" && engine != "BITS" && engine != "SPARSE" && engine != "AUTO") {
+    fprintf(stderr, "engine must be LOOP, SAT, BITS, SPARSE or AUTO\n");
+    exit(1);
+  }
 
   fin.clear();
   fin.open(fn);
   if (fin.fail()) { perror(fn.c_str()); exit(1); }
 
-  while (getline(fin, line)) events.push_back(line);
-  fin.close();
-
-  for (i = 0; i < (int) events.size(); i++) {
-    for (j = 0; j < (int) events[i].size(); j++) {
-      if (events[i][j] != '0' && events[i][j] != '1') {
-        fprintf(stderr, "Non-zero/one character at row %d col %d\n", i, j);
-        exit(1);
-      }
+  while (getline(fin, line)) {
+    if (events.Rows == 0) events.Resize(0, line.size());
+    j = events.Add_Row(line);
+    if (j != -1) {
+      fprintf(stderr, "Non-zero/one character at row %d col %d\n", events.Rows-1, j);
+      exit(1);
     }
-    if (events[i].size() != events[0].size()) {
-      fprintf(stderr, "Error -- lines %d and %d are different sizes\n", i, j);
+    if ((int) line.size() != events.Cols) {
+      fprintf(stderr, "Error -- lines %d and %d are different sizes\n", events.Rows-1, 0);
     }
   }
+  fin.close();
+
+  R = events.Rows;
+  C = events.Cols;
 
-  if (sr >= (int) events.size()) { fprintf(stderr, "sr too big\n"); exit(1); }
-  if (sc >= (int) events[0].size()) { fprintf(stderr, "sc too big\n"); exit(1); }
+  if (sr >= R) { fprintf(stderr, "sr too big\n"); exit(1); }
+  if (sc >= C) { fprintf(stderr, "sc too big\n"); exit(1); }
 
   if (DEBUG) {
-    for (i = 0; i < (int) events.size(); i++) {
-      for (j = 0; j < (int) events[0].size(); j++) {
-        t = -(events[i][j] - '0');
+    for (i = 0; i < R; i++) {
+      for (j = 0; j < C; j++) {
+        t = -events.Get(i, j);
         for (ii = i-e; ii <= i+e; ii++) {
           for (jj = j-e; jj <= j+e; jj++) {
-            if (ii >= 0 && ii < (int) events.size() && jj >= 0 && jj < (int) events[0].size()) {
-              t += (events[ii][jj] - '0');
-            }
+            if (ii >= 0 && ii < R && jj >= 0 && jj < C) t += events.Get(ii, jj);
           }
         }
         printf("%3d", t);
@@ -79,46 +112,30 @@ int main(int argc, char **argv)
       printf("\n");
     }
   }
-  
-  ceb = events;
 
-  for (i = 0; i < (int) ceb.size(); i++) for (j = 0; j < (int) ceb[0].size(); j++) ceb[i][j] = '.';
+  DBSCAN dbscan(R, C, e, 0, mp, engine);
+  labels.resize((size_t) R * C);
+  dbscan.Push(events, &labels[0]);
 
-  for (i = 0; i < (int) events.size(); i++) {
-    for (j = 0; j < (int) events[0].size(); j++) {
-      if (events[i][j] == '1') {
-        t = 0;
-        for (ii = i-e; ii <= i+e; ii++) {
-          for (jj = j-e; jj <= j+e; jj++) {
-            if (ii >= 0 && ii < (int) events.size() && jj >= 0 && jj < (int) events[0].size()) {
-              t += (events[ii][jj] - '0');
-            }
-          }
-        }
-        if (t >= mp) ceb[i][j] = 'C';
-      }
-    }
-  }
+  /* With -c, the labels go to the clusters, and we print the cluster of each event. */
 
-  for (i = 0; i < (int) events.size(); i++) {
-    for (j = 0; j < (int) events[0].size(); j++) {
-      if (events[i][j] == '1' && ceb[i][j] != 'C') {
-        t = 0;
-        for (ii = i-e; ii <= i+e; ii++) {
-          for (jj = j-e; jj <= j+e; jj++) {
-            if (ii >= 0 && ii < (int) events.size() && jj >= 0 && jj < (int) events[0].size()) {
-              if (ceb[ii][jj] == 'C') ceb[i][j] = 'B';
-            }
-          }
-        }
+  if (cluster) {
+    clusters.Setup(R, C, e, 0);
+    clusters.Push(labels.c_str());
+    clusters.Finish();
+    for (w = 0; w < clusters.Events.size(); w++) {
+      ev = &clusters.Events[w];
+      if (ev->Row >= sr && ev->Row < sr + ir && ev->Col >= sc && ev->Col < sc + ic) {
+        printf("%d %d %c %d\n", ev->Row, ev->Col, ev->Label, ev->Cluster);
       }
     }
+    return 0;
   }
 
   for (i = sr; i < sr + ir; i++) {
     for (j = sc; j < sc + ic; j++) {
-      if (i < (int) ceb.size() && j < (int) ceb[0].size()) {
-        printf("%c", ceb[i][j]); 
+      if (i < R && j < C) {
+        printf("%c", labels[(size_t) i*C+j]);
       } else {
         printf(".");
       }
@@ -128,4 +145,3 @@ int main(int argc, char **argv)
 
   return 0;
 }
-
@@ -0,0 +1,300 @@
+/* This program does everything that scripts/process_dbscan_full.sh, process_dbscan_partial.sh,
+   process_3d_dbscan_full.sh and process_3d_dbscan_partial.sh do, in one process: it makes the
+   network, turns the events into input spikes, runs the network, and turns the output spikes
+   into the grid of labeled events.  The stages hand each other their data in memory, using
+   the same code as the programs that the scripts call:
+
+     - include/dbscan_networks.hpp makes the network, in the binary format, into a string,
+       which the simulator reads with SNN_Network::From_Memory().
+     - include/dbscan_spikes.hpp makes the spikes, a frame at a time, and they go straight
+       to Apply_Spike().  The network runs up to each frame before it's read, so only one
+       frame is in memory, and the input can be a stream of frames.
+     - include/dbscan_outputs.hpp turns the simulator's output spike times into labels.
+
+   So there are no temporary files, and you can run as many of these at once as you want,
+   which you can't do with the scripts, because they all use the same tmp-xxx.txt files.
+   The output is the same as the scripts' output.
+
+   In the STREAM modes, the labels go into a DBSCAN_Stream_Labels as the network runs, and
+   each frame is printed as soon as the network is done with it, rather than at the end.
+
+   The arguments are the scripts' arguments, with epsilon_t in the 2D modes too (where it is
+   ignored), and with the simulator engine (see bin/snn_sim) instead of the framework
+   directory.  The data file can be "-" for standard input.  With I_R I_C sr sc, it does what
+   the partial scripts do, and otherwise, what the full scripts do.  The STREAM modes have to
+   be partial.
+ */
+
+/* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "snn_network.hpp"
+#include "network_builder.hpp"
+#include "snn_simulator.hpp"
+#include "layer_simulator.hpp"
+#include "dbscan_networks.hpp"
+#include "dbscan_spikes.hpp"
+#include "dbscan_outputs.hpp"
+using namespace std;
+
+void usage(const string &s)
+{
+  fprintf(stderr, "usage: bin/dbscan_pipeline epsilon epsilon_t minpoints data_file|- [I_R I_C sr sc] mode [EVENT|LAYER|AUTO]\n");
+  fprintf(stderr, "       mode is FLAT, SYSTOLIC, 3D_FLAT or 3D_SYSTOLIC, or with I_R I_C sr sc,\n");
+  fprintf(stderr, "       also 3D_FLAT_STREAM, 3D_SYSTOLIC_STREAM or 3D_SYSTOLIC_STREAM_AS\n");
+  if (s != "") fprintf(stderr, "%s\n", s.c_str());
+  exit(1);
+}
+
+bool is_number(const char *s)
+{
+  char *end;
+
+  strtol(s, &end, 10);
+  return s[0] != '\0' && *end == '\0';
+}
+
+/* Run the network, and add its output spikes to outs, as times from the start.  If sl isn't
+   NULL, they go to sl instead, and it prints the frames that are done. */
+
+void Run(SNN_Simulator *sim, int duration, int elapsed, vector <DBSCAN_Output> &outs,
+         DBSCAN_Stream_Labels *sl, int frames)
+{
+  int i, t;
+  size_t j;
+  DBSCAN_Output *o;
+
+  sim->Run(duration);
+  for (i = 0; i < sim->Num_Outputs(); i++) {
+    o = &outs[i];
+    for (j = 0; j < sim->Output_Times(i).size(); j++) {
+      t = sim->Output_Times(i)[j] + elapsed;
+      if (sl != NULL) {
+        sl->Add(o->Cell, o->Row, o->Col, t, i);
+      } else {
+        o->Times.push_back(t);
+      }
+    }
+    o->Count = o->Times.size();
+  }
+  if (sl != NULL) sl->Flush(elapsed + duration, frames);
+}
+
+int main(int argc, char **argv)
+{
+  int e, e_t, mp, ir, ic, sr, sc, R, C, frames, rt, max_delay, rdi, cdi, na;
+  int i, elapsed, next;
+  bool partial;
+  string fn, mode, engine, params, bin, why;
+  ifstream fin;
+  DBSCAN_Spike_Encoder enc;
+  istream *in;
+  vector <DBSCAN_Spike> spikes;
+  vector <DBSCAN_Output> outs;
+  vector <int> input_index;
+  Network_Builder nb;
+  SNN_Network net;
+  SNN_Simulator *sim;
+  Layer_Simulator *layers;
+  DBSCAN_Stream_Labels stream, *sl;
+  int n;
+  char buf[200];
+
+  if (argc < 6) usage("");
+
+  e = atoi(argv[1]);
+  e_t = atoi(argv[2]);
+  mp = atoi(argv[3]);
+  fn = argv[4];
+
+  /* The mode is the first argument after the data file that isn't a number. */
+
+  for (na = 5; na < argc && is_number(argv[na]); na++) ;
+  partial = false;
+  ir = ic = sr = sc = 0;
+  if (na == 9) {
+    partial = true;
+    ir = atoi(argv[5]);
+    ic = atoi(argv[6]);
+    sr = atoi(argv[7]);
+    sc = atoi(argv[8]);
+  } else if (na != 5) {
+    usage("");
+  }
+  if (na >= argc || argc > na + 2) usage("");
+  mode = argv[na];
+  engine = (argc == na + 2) ? argv[na+1] : "AUTO";
+
+  if (mode != "FLAT" && mode != "SYSTOLIC" && mode != "3D_FLAT" && mode != "3D_SYSTOLIC" &&
+      mode != "3D_FLAT_STREAM" && mode != "3D_SYSTOLIC_STREAM" && mode != "3D_SYSTOLIC_STREAM_AS") {
+    usage("Bad mode " + mode);
+  }
+  if (!partial && mode.find("STREAM") != string::npos) usage("The STREAM modes need I_R I_C sr sc");
+  if (engine != "EVENT" && engine != "LAYER" && engine != "AUTO") usage("Bad engine " + engine);
+  if (partial && (ir < 1 || ic < 1)) usage("I_R and I_C have to be > 0");
+
+  /* Read the first frame, which sets the size of the grid, like in the scripts.  The rest
+     are read as the network runs. */
+
+  if (partial) {
+    enc.Partial(mode, ir, ic, sr, sc, e);
+  } else {
+    enc.Full(mode, e);
+  }
+  if (fn != "-") {
+    fin.open(fn.c_str());
+    if (fin.fail()) { perror(fn.c_str()); exit(1); }
+  }
+  in = (fn == "-") ? (istream *) &cin : (istream *) &fin;
+  if (!enc.Next_Frame(*in)) return 0;
+
+  R = enc.Rows;
+  C = enc.Cols;
+  rdi = (R + ir - 1) / max(ir, 1);
+  cdi = (C + ic - 1) / max(ic, 1);
+
+  /* The max_delay of each mode. */
+
+  max_delay = 4;
+  if (mode == "3D_SYSTOLIC") {
+    max_delay = (partial) ? ic + 4*e + 4 : C + 2*e + 4;
+  } else if (mode == "3D_FLAT_STREAM") {
+    max_delay = max(rdi * cdi, 4);
+  } else if (mode == "3D_SYSTOLIC_STREAM" || mode == "3D_SYSTOLIC_STREAM_AS") {
+    max_delay = rdi * (C + 4*e);
+  }
+
+  snprintf(buf, sizeof(buf), "{ \"discrete\": true, \"leak_mode\": \"all\", \"max_delay\": %d, "
+           "\"max_threshold\": %d, ", max_delay, mp);
+  params = buf;
+  params += "\"max_weight\": 1.0, \"spike_value_factor\": 1.0, \"min_potential\": 0.0, "
+            "\"min_threshold\": 1.0, \"min_weight\": -1.0 }";
+
+  /* Make the network, in memory. */
+
+  nb.Write_To(&bin);
+  nb.Start_JSON(SNN_Empty_Network(params), "BINARY");
+  if (mode == "FLAT") {
+    if (partial) DBSCAN_Flat_Partial(nb, ir, ic, e, mp); else DBSCAN_Flat_Full(nb, R, C, e, mp);
+  } else if (mode == "SYSTOLIC") {
+    if (partial) DBSCAN_Systolic_Partial(nb, ir, e, mp); else DBSCAN_Systolic_Full(nb, R, e, mp);
+  } else if (mode == "3D_FLAT") {
+    if (partial) DBSCAN_3D_Flat_Partial(nb, ir, ic, e, e_t, mp); else DBSCAN_3D_Flat_Full(nb, R, C, e, e_t, mp);
+  } else if (mode == "3D_SYSTOLIC") {
+    if (partial) DBSCAN_3D_Systolic_Partial(nb, ir, ic, e, e_t, mp); else DBSCAN_3D_Systolic_Full(nb, R, C, e, e_t, mp);
+  } else if (mode == "3D_FLAT_STREAM") {
+    DBSCAN_3D_Flat_Partial_Stream(nb, R, C, ir, ic, e, e_t, mp);
+  } else {
+    DBSCAN_3D_Systolic_Partial_Stream(nb, R, C, ir, ic, e, e_t, mp);
+  }
+  nb.Finish();
+  net.From_Memory(bin.data(), bin.size(), "the network");
+
+  sim = NULL;
+  if (engine != "EVENT") {
+    layers = new Layer_Simulator;
+    if (engine == "LAYER") {
+      layers->Load(net);
+      sim = layers;
+    } else if (layers->Try_Load(net, why)) {
+      sim = layers;
+    } else {
+      delete layers;
+    }
+  }
+  if (sim == NULL) {
+    sim = new SNN_Simulator;
+    sim->Load(net);
+  }
+
+  /* The outputs, in the network's order. */
+
+  outs.resize(sim->Num_Outputs());
+  for (i = 0; i < sim->Num_Outputs(); i++) {
+    DBSCAN_Output &o = outs[i];
+    const char *name = net.Name(sim->Output_Node(i));
+    if (sscanf(name, "Core[%d][%d]", &o.Row, &o.Col) == 2) {
+      o.Cell = 'C';
+    } else if (sscanf(name, "Border[%d][%d]", &o.Row, &o.Col) == 2) {
+      o.Cell = 'B';
+    } else {
+      fprintf(stderr, "Output %d (%s) isn't a Core or Border neuron\n", i, name);
+      exit(1);
+    }
+    o.Count = 0;
+  }
+
+  input_index.assign(net.Nodes, -1);
+  for (i = 0; i < (int) net.Num_Inputs; i++) input_index[net.Inputs[i]] = i;
+
+  sl = NULL;
+  if (mode == "3D_FLAT_STREAM") {
+    stream.Flat(R, C, ir, ic, e);
+    sl = &stream;
+  } else if (mode == "3D_SYSTOLIC_STREAM" || mode == "3D_SYSTOLIC_STREAM_AS") {
+    stream.Systolic(R, C, ir, e);
+    sl = &stream;
+  }
+
+  /* Apply each frame's spikes as it's read, and then run the network up to the next frame's
+     first timestep, since none of the next frame's spikes can affect anything earlier.  So
+     only one frame is ever in memory, and the network runs while the frames are still
+     coming. */
+
+  elapsed = 0;
+  do {
+    spikes.clear();
+    enc.Spikes(spikes);
+    for (i = 0; i < (int) spikes.size(); i++) {
+      n = spikes[i].Node;
+      if (n < 0 || n >= (int) net.Nodes || input_index[n] < 0) {
+        fprintf(stderr, "Node %d isn't an input\n", n);
+        exit(1);
+      }
+      sim->Apply_Spike(input_index[n], spikes[i].Time - elapsed, 1);
+    }
+    next = enc.Frame_Start(enc.Frame + 1);
+    if (next > elapsed) {
+      Run(sim, next - elapsed, elapsed, outs, sl, enc.Frame + 1);
+      elapsed = next;
+    }
+  } while (enc.Next_Frame(*in));
+  frames = enc.Frame + 1;
+
+  /* The scripts' run time for each mode. */
+
+  if (mode == "FLAT") {
+    rt = 5;
+  } else if (mode == "SYSTOLIC") {
+    rt = (partial) ? ic + e*4 + 4 : C + e*2 + 4;
+  } else if (mode == "3D_FLAT") {
+    rt = frames + 4;
+  } else if (mode == "3D_SYSTOLIC") {
+    rt = frames * max_delay;
+  } else if (mode == "3D_FLAT_STREAM") {
+    rt = frames * rdi * cdi + 4;
+  } else {
+    rt = frames * max_delay + 4;
+  }
+  if (rt > elapsed) Run(sim, rt - elapsed, elapsed, outs, sl, frames);
+  delete sim;
+
+  if (sl != NULL) {
+    sl->Finish(frames);
+  } else if (mode == "FLAT") {
+    DBSCAN_Output_Flat(outs);
+  } else if (mode == "SYSTOLIC") {
+    if (partial) DBSCAN_Output_Systolic_Partial(outs, e, ic); else DBSCAN_Output_Systolic_Full(outs, e, C);
+  } else if (mode == "3D_FLAT") {
+    if (partial) DBSCAN_Output_3D_Flat_Partial(outs, ir, ic, e, frames); else DBSCAN_Output_3D_Flat_Full(outs, R, C, frames);
+  } else if (mode == "3D_SYSTOLIC") {
+    if (partial) DBSCAN_Output_3D_Systolic_Partial(outs, ir, ic, e, frames); else DBSCAN_Output_3D_Systolic_Full(outs, e, R, C, frames);
+  }
+  return 0;
+}
@@ -1,5 +1,20 @@
 /* This program reads in a csv file of event camera events, creates event frames that are segment_time_length
-microseconds long, and outputs them in the format required by the DBSCAN programs in this repository.  */
+microseconds long, and outputs them in the format required by the DBSCAN programs in this repository.
+
+The file can also be an AEDAT4 recording, straight from the camera (see include/aedat4.hpp), which
+is read a packet at a time, without converting it to text.
+
+A csv file is mmap'd and cut into chunks at line boundaries, which a pool of threads (-j, all of
+the cores by default) parses with a hand-written integer parser.  The chunks are binned in file
+order, as they finish, so the frames are the same as reading the file a line at a time, and only
+a few chunks' events are ever in memory.  Files that can't be mmap'd (pipes) are read a line at
+a time with sscanf(), as before.  The reading is in include/event_file.hpp, which bin/event_dbscan
+shares.
+
+With -b, the frames are written in the binary format of include/frame_file.hpp, which is as big
+as the number of events, rather than R*C characters per frame.  With -b -p, they keep the events'
+polarity: each frame has a channel of ON cells and a channel of OFF cells (polarity 0 is OFF),
+which bin/3d_dbscan -p clusters separately. */
 
 /* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
 
@@ -15,139 +30,173 @@ microseconds long, and outputs them in the format required by the DBSCAN program
 #include <fstream>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "event_file.hpp"
+#include "frame_file.hpp"
 using namespace std;
 
-struct Event
-{
-    short x;
-    short y;
-    signed char polarity;
+/* This bins the events into frames.  Each frame is printed as soon as an event shows up
+   that's past it.
+
+   The frame is kept as the text that gets printed -- R lines of '0's and '1's, and a blank
+   line -- which is allocated once and printed with one fwrite().  Touched holds the cells that
+   have been set in the current frame, once each, so after the frame is printed, only those
+   are set back to '0'.  With -b, touched is the frame's list of cells.  Nothing is allocated
+   once touched has grown to the biggest frame.
+
+   With polarity, the frame isn't printed as text, so its characters are '0' plus bit 1 for an
+   ON event and bit 2 for an OFF event, and touched and touched_off are the two channels. */
+
+class Framer {
+  public:
+    int r, c;
+    long long segment_time_length;
+    bool binary = false;                 // Write include/frame_file.hpp frames to stdout
+    bool keep_polarity = false;          // With binary, keep ON and OFF apart
+    Frame_File_Writer writer;            // Opened by the caller, if binary
+
+    void Add(long long time, short x, short y, signed char polarity);
+    void Finish();
+
+  protected:
+    bool first = true;
+    long long observation_start_time, observation_end_time;
+    string text;                         // The frame, as it's printed
+    vector <uint32_t> touched;           // Cells (row*c+col) that are '1' in text
+    vector <uint32_t> touched_off;       // With polarity, the cells with an OFF event
+
+    void Print_Frame();
 };
 
-int main(int argc, char **argv)
+void Framer::Print_Frame()
 {
-  int r, c, i, j, k;
-  string file, line;
-  ifstream fin;
-  short x, y;
-  long long time,observation_start_time, observation_end_time, segment_time_length;
-  signed char polarity;
-  bool first;
-  int rv;
-  vector <Event> tmp;
-  //vector < vector <Event>> frames;
-  vector < vector <int> > template_frame;
-  Event event;
-  
-  if (argc != 5) {
-    fprintf(stderr, "usage: bin/ebc_to_frames R C file segment_time_length(microseconds)\n");
-    exit(1);
+  size_t i;
+
+  if (keep_polarity) {
+    sort(touched.begin(), touched.end());
+    sort(touched_off.begin(), touched_off.end());
+    writer.Write(touched, touched_off);
+    for (i = 0; i < touched_off.size(); i++) text[touched_off[i] + touched_off[i] / c] = '0';
+    touched_off.clear();
+  } else if (binary) {
+    sort(touched.begin(), touched.end());
+    writer.Write(touched);
+  } else {
+    fwrite(text.data(), 1, text.size(), stdout);
   }
 
-  r = atoi(argv[1]);
-  c = atoi(argv[2]);
-  file = argv[3];
-  segment_time_length = atoi(argv[4]);
+  for (i = 0; i < touched.size(); i++) text[touched[i] + touched[i] / c] = '0';
+  touched.clear();
+}
 
-  fin.clear();
-  fin.open(file);
-  if (fin.fail()) { perror(file.c_str()); exit(1); }
+// Unless we're keeping polarity, we ignore the individual events' polarities.
+void Framer::Add(long long time, short x, short y, signed char polarity)
+{
+  size_t cell;
+  long long skip;
+  int j, bit;
 
-  first = true;
+  if(x < 0 || x >= c){
+    fprintf(stderr,"Bad value for x (column value): %d.\n0 <= x < %d\n",x,c);
+    exit(1);
+  }
+  if(y < 0 || y >= r){
+    fprintf(stderr,"Bad value for y (row value): %d.\n0 <= y < %d\n",y,r);
+    exit(1);
+  }
 
-  
-  while(getline(fin,line)){
-    rv = sscanf(line.c_str(),"%lld,%hd,%hd,%hhd",&time,&x,&y,&polarity);
-    if(rv != 4) {
-      fprintf(stderr,"Trouble parsing line: %s\n\nExpected format is: time,x,y,polarity\n",line.c_str());
-      exit(1);
-    }
-    if(x < 0 || x >= c){
-      fprintf(stderr,"Bad value for x (column value): %d.\n0 <= x < %d\n",x,c);
-      exit(1);
-    }
-    if(y < 0 || y >= r){
-      fprintf(stderr,"Bad value for y (row value): %d.\n0 <= y < %d\n",y,r);
-      exit(1);
-    }
+  if(first){
+      observation_start_time = time;
+      observation_end_time = observation_start_time + segment_time_length;
+      first = false;
+      text.assign((size_t) r * (c + 1) + 1, '0');
+      for (j = 0; j <= r; j++) text[(size_t) j * (c + 1) + ((j < r) ? c : 0)] = '\n';
+  }
 
-    if(first){
-        observation_start_time = time;
-        observation_end_time = observation_start_time + segment_time_length;
-        first = false;
-    }
-    // At each step, we need to calculate whether we need to pad with null events,
-    // or continue to concatenate onto the one we've been working on..
-    // Basically, we want to end up with (last_time - first_time) / segment_time_length frames 
-    // in total, which might mean having observations with no events.
-    if(time >= observation_start_time && time < observation_end_time){
-        // Internally represent -1 as neg polarity, 0 as null, and 1 as positive polarity
-        event = {
-                  .x = x, 
-                  .y = y, 
-                  .polarity = static_cast<signed char>((polarity == 0) ? -1 : polarity)
-                };
-        
-        tmp.push_back(event);
-    }else{
-        // Output the frame, move on
-        template_frame = vector < vector <int>> (r, vector <int> (c, 0));
-
-        for (i = 0; i < (int) tmp.size(); i++) {
-          template_frame[tmp[i].y][tmp[i].x] = 1; // We're ignoring the individual events' polarities
-        }
-
-        for (j = 0; j < r; j++) {
-          for (k = 0; k < c; k++) {
-            printf("%d",template_frame[j][k]);
-          }
-          printf("\n");
-        }
-        printf("\n");
-        
-        tmp.clear();
-
-        // Advance observation time window
-        observation_start_time = observation_end_time;
-        observation_end_time += segment_time_length;
-
-        // Because there might be large gaps of time without events, continue advancing the observation time window and appending empty observations
-        while(time >= observation_end_time){
-            observation_start_time = observation_end_time;
-            observation_end_time += segment_time_length; 
-        }
-
-        event = {
-                  .x = x, 
-                  .y = y, 
-                  .polarity = static_cast<signed char>((polarity == 0) ? -1 : polarity)
-                };
-        
-        tmp.push_back(event);
+  // At each step, we need to calculate whether we need to pad with null events,
+  // or continue to concatenate onto the one we've been working on..
+  // Basically, we want to end up with (last_time - first_time) / segment_time_length frames
+  // in total, which might mean having observations with no events.
+  if(!(time >= observation_start_time && time < observation_end_time)){
+      // Output the frame, move on
+      Print_Frame();
+
+      // Advance observation time window
+      observation_start_time = observation_end_time;
+      observation_end_time += segment_time_length;
+
+      // Because there might be large gaps of time without events, skip ahead to the window
+      // that holds this event -- all at once, rather than a window at a time.
+      if(time >= observation_end_time){
+          skip = (time - observation_end_time) / segment_time_length + 1;
+          observation_end_time += skip * segment_time_length;
+          observation_start_time = observation_end_time - segment_time_length;
+      }
+  }
+
+  cell = (size_t) y * c + x;
+  if (keep_polarity) {
+    bit = (polarity > 0) ? 1 : 2;
+    if (!((text[cell + y] - '0') & bit)) {
+      text[cell + y] |= bit;
+      ((bit == 1) ? touched : touched_off).push_back(cell);
     }
+  } else if (text[cell + y] == '0') {
+    text[cell + y] = '1';
+    touched.push_back(cell);
   }
+}
 
-  // Add the very last, partially filled observation to the list of observations. 
-  if(tmp.size() > 0){
-    // Output final partial frame
-    template_frame = vector < vector <int>> (r, vector <int> (c, 0));
+// Add the very last, partially filled observation to the list of observations.
+void Framer::Finish()
+{
+  if(touched.size() > 0 || touched_off.size() > 0) Print_Frame();
+  if (binary) writer.Close();
+}
 
-    for (i = 0; i < (int) tmp.size(); i++) {
-      template_frame[tmp[i].y][tmp[i].x] = 1; // We're ignoring the individual events' polarities
-    }
+/* ------------------------------------------------------------ */
 
-    for (j = 0; j < r; j++) {
-      for (k = 0; k < c; k++) {
-        printf("%d",template_frame[j][k]);
-      }
-      printf("\n");
+int main(int argc, char **argv)
+{
+  int threads;
+  bool usage;
+  size_t i;
+  Framer framer;
+
+  threads = -1;
+  usage = (argc < 5);
+  for (i = 5; i < (size_t) argc; i++) {
+    if (string(argv[i]) == "-j" && i+1 < (size_t) argc) {
+      threads = atoi(argv[i+1]);
+      if (threads < 1) { fprintf(stderr, "threads must be >= 1\n"); exit(1); }
+      i++;
+    } else if (string(argv[i]) == "-b") {
+      framer.binary = true;
+    } else if (string(argv[i]) == "-p") {
+      framer.keep_polarity = true;
+    } else {
+      usage = true;
     }
-    printf("\n");
-    
-    tmp.clear();
   }
-
-  fin.close();
-
+  if (usage) {
+    fprintf(stderr, "usage: bin/ebc_to_frames R C file segment_time_length(microseconds) [-j threads] [-b [-p]]\n");
+    fprintf(stderr, "       file is a csv file of time,x,y,polarity, or an AEDAT4 file\n");
+    fprintf(stderr, "       -b writes binary frames (include/frame_file.hpp), and -p keeps ON and OFF apart\n");
+    exit(1);
+  }
+  if (framer.keep_polarity && !framer.binary) { fprintf(stderr, "-p needs -b\n"); exit(1); }
+
+  framer.r = atoi(argv[1]);
+  framer.c = atoi(argv[2]);
+  framer.segment_time_length = atoi(argv[4]);
+  if (framer.segment_time_length < 1) { fprintf(stderr, "segment_time_length must be > 0\n"); exit(1); }
+  if (threads == -1) threads = thread::hardware_concurrency();
+  if (threads < 1) threads = 1;
+  if (framer.binary) framer.writer.Open(stdout, framer.r, framer.c, framer.segment_time_length,
+                                        (framer.keep_polarity) ? 2 : 1);
+
+  Read_Event_File(argv[3], framer, threads);
+  framer.Finish();
   return 0;
 }
@@ -0,0 +1,148 @@
+/* This program runs 3D DBSCAN on a file of event-camera events directly, without binning them
+   into frames first.  The file is a csv file of time,x,y,polarity lines, or an AEDAT4 recording,
+   read by include/event_file.hpp just like bin/ebc_to_frames reads it, and the clustering is
+   include/event_dbscan.hpp.  It prints each event with its label, in the order of the file:
+
+   time,x,y,polarity,label
+
+   where the label is C (Core), B (Border) or . (Noise).  Epsilon_t is in microseconds.  An
+   event_file of - reads standard input.  With -p, ON and OFF events are clustered separately.
+   The output is built in a buffer and written in big pieces, unless you give -f, which writes
+   it out every time a timestamp is labeled, for a live consumer on the other end of a pipe. */
+
+/* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "event_file.hpp"
+#include "event_dbscan.hpp"
+using namespace std;
+
+/* This is the sink for Read_Event_File().  It hands each event to the Event_DBSCAN, and prints
+   the events that come back labeled. */
+
+class Printer {
+  public:
+    Event_DBSCAN *dbscan;
+    bool flush_each = false;
+
+    void Add(long long t, short x, short y, signed char polarity);
+    void Finish();
+
+  protected:
+    vector <char> buf;
+    size_t n = 0;
+
+    void Print(const vector <Event_DBSCAN_Event> &events);
+    void Put_Number(long long v);
+    void Write();
+};
+
+void Printer::Add(long long t, short x, short y, signed char polarity)
+{
+  if (dbscan->Add(t, x, y, polarity)) Print(dbscan->Labeled);
+}
+
+void Printer::Finish()
+{
+  if (dbscan->Flush()) Print(dbscan->Labeled);
+  Write();
+}
+
+void Printer::Put_Number(long long v)
+{
+  char digits[24];
+  unsigned long long u;
+  int i;
+
+  if (v < 0) buf[n++] = '-';
+  u = (v < 0) ? -(unsigned long long) v : v;
+  i = 0;
+  do {
+    digits[i++] = '0' + u % 10;
+    u /= 10;
+  } while (u != 0);
+  while (i > 0) buf[n++] = digits[--i];
+}
+
+/* A line is at most 20+1+6+1+6+1+4+1+1+1 characters, so each event gets 64 bytes of room. */
+
+void Printer::Print(const vector <Event_DBSCAN_Event> &events)
+{
+  size_t i;
+
+  for (i = 0; i < events.size(); i++) {
+    if (buf.size() - n < 64) {
+      if (n >= (1 << 16)) Write();
+      if (buf.size() - n < 64) buf.resize(n + (1 << 17));
+    }
+    Put_Number(events[i].T);
+    buf[n++] = ',';
+    Put_Number(events[i].X);
+    buf[n++] = ',';
+    Put_Number(events[i].Y);
+    buf[n++] = ',';
+    Put_Number(events[i].Polarity);
+    buf[n++] = ',';
+    buf[n++] = events[i].Label;
+    buf[n++] = '\n';
+  }
+  if (flush_each) Write();
+}
+
+void Printer::Write()
+{
+  if (n > 0 && fwrite(buf.data(), 1, n, stdout) != n) { perror("event_dbscan: stdout"); exit(1); }
+  n = 0;
+  fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+  int e, mp, rows, cols, threads;
+  long long et;
+  bool polarity, usage;
+  size_t i;
+  Printer printer;
+
+  threads = -1;
+  polarity = false;
+  usage = (argc < 7);
+  for (i = 7; i < (size_t) argc; i++) {
+    if (string(argv[i]) == "-j" && i+1 < (size_t) argc) {
+      threads = atoi(argv[i+1]);
+      if (threads < 1) { fprintf(stderr, "threads must be >= 1\n"); exit(1); }
+      i++;
+    } else if (string(argv[i]) == "-p") {
+      polarity = true;
+    } else if (string(argv[i]) == "-f") {
+      printer.flush_each = true;
+    } else {
+      usage = true;
+    }
+  }
+  if (usage) {
+    fprintf(stderr, "usage: bin/event_dbscan epsilon epsilon_t(microseconds) minpoints event_file R C [-j threads] [-p] [-f]\n");
+    fprintf(stderr, "       event_file is a csv file of time,x,y,polarity, or an AEDAT4 file\n");
+    fprintf(stderr, "       -p clusters ON and OFF events separately, and -f flushes the output at every timestamp\n");
+    exit(1);
+  }
+
+  e = atoi(argv[1]);
+  et = atoll(argv[2]);
+  mp = atoi(argv[3]);
+  rows = atoi(argv[5]);
+  cols = atoi(argv[6]);
+  if (threads == -1) threads = thread::hardware_concurrency();
+  if (threads < 1) threads = 1;
+
+  Event_DBSCAN dbscan(rows, cols, e, et, mp, polarity);
+  printer.dbscan = &dbscan;
+  Read_Event_File((string(argv[4]) == "-") ? "/dev/stdin" : argv[4], printer, threads);
+  printer.Finish();
+  return 0;
+}
@@ -1,4 +1,5 @@
-/* This program uses FFMPEG to create a video of events at 60 FPS of pre or post DBSCAN application.  */
+/* This program uses FFMPEG to create a video of events at 60 FPS of pre or post DBSCAN application.
+   The events can also be the binary frames of bin/ebc_to_frames -b (include/frame_file.hpp). */
 
 /* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
 
@@ -9,6 +10,7 @@
 #include <string.h>
 #include <errno.h>
 #include <sys/wait.h>
+#include "frame_file.hpp"
 
 using namespace std;
 
@@ -25,6 +27,7 @@ int main(int argc, char **argv)
   vector <vector <string>> frames;
   vector <string> frame;
   string line;
+  Frame_File_Reader ff;
 
   if (argc > 5) {
     fprintf(stderr, "usage: ./event_viz R C event_file/dbscanned_event_file video_filename\n");
@@ -72,12 +75,23 @@ int main(int argc, char **argv)
   fin.open(event_fn);
   if (fin.fail()) { perror(event_fn.c_str()); exit(1); }
 
-  while(getline(fin,line)){
-    if(line == ""){
+  if (ff.Open(fin)) {
+    if (ff.Rows != height || ff.Cols != width) {
+      fprintf(stderr, "%s is %dx%d, not %dx%d\n", event_fn.c_str(), ff.Rows, ff.Cols, height, width);
+      exit(1);
+    }
+    while (ff.Next()) {
+      ff.Lines(frame);
       frames.push_back(frame);
-      frame.clear();   
-    }else{
-      frame.push_back(line);
+    }
+  } else {
+    while(getline(fin,line)){
+      if(line == ""){
+        frames.push_back(frame);
+        frame.clear();   
+      }else{
+        frame.push_back(line);
+      }
     }
   }
 
@@ -0,0 +1,521 @@
+/* libdbscan -- see include/dbscan.hpp for the interface.
+
+   The frames are labeled one at a time by an "engine".  Frame i's labels only depend on frames
+   i-e_t..i, so each engine keeps the last e_t+1 frames of whatever it needs, and labels frame i
+   as soon as it gets it.  There are four engines, and their outputs are identical:
+
+   - LOOP is not very efficient: each On event loops over its whole (e_t+1)x(2e+1)x(2e+1)
+     space-time window.
+   - SAT keeps a summed-area table (2D prefix sum) for each of the last e_t+1 frames, plus a
+     running sum of those tables.  Each window count is then four lookups into the running sum.
+     It does the same with the cores to find the borders.
+   - BITS works on the events packed 64 to a word (include/bitgrid.hpp).  It keeps the
+     bit-sliced box counts of the last e_t+1 frames and their running sum, plus the box-dilated
+     cores of the last e_t+1 frames.
+   - SPARSE keeps each of the last e_t+1 frames as a list of its events' columns, sorted by row
+     and column, with the start of each row.  It only visits the events, and counts each row of
+     a window with two binary searches, so its time goes with the number of events rather than
+     the number of cells.  It does the same with the cores to find the borders.
+
+   Charles P. Rizzo, James S. Plank, University of Tennessee, 2025
+ */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include "dbscan.hpp"
+using namespace std;
+
+/* Push() takes frame i's events and sets labels to frame i's labels: R*C characters,
+   row-major, each of which is 'C', 'B' or '.'.  The frames must be pushed in order.
+   Each engine sizes all of its memory for R, C, e and e_t when it is made (or on the
+   first frames that fill its rings), and then reuses it, so that Push() doesn't allocate.
+   The exception is SPARSE, whose event lists grow when a frame has more events than
+   any frame before it. */
+
+class DBSCAN_Engine {
+  public:
+    virtual ~DBSCAN_Engine() {}
+    virtual void Push(const BitGrid &frame, char *labels) = 0;
+};
+
+class Loop_Engine : public DBSCAN_Engine {
+  public:
+    Loop_Engine(int R, int C, int e, int et, int mp);
+    void Push(const BitGrid &frame, char *labels);
+  protected:
+    int R, C, e, et, mp;
+    int N;                                 // Number of frames pushed so far
+    vector <BitGrid> events;               // The last e_t+1 frames (a ring)
+    vector <string> ceb;                   // Their labels, R*C each (a ring)
+};
+
+class Sat_Engine : public DBSCAN_Engine {
+  public:
+    Sat_Engine(int R, int C, int e, int et, int mp);
+    void Push(const BitGrid &frame, char *labels);
+  protected:
+    int Box(const vector <int> &sum, int j, int k) const;
+    void Build(vector <int> &sat, const BitGrid *frame, const char *labels);
+    int R, C, e, et, mp;
+    int N;
+    vector < vector <int> > sats;          // Summed-area tables of the last e_t+1 frames (a ring)
+    vector < vector <int> > csats;         // Summed-area tables of their cores (a ring)
+    vector <int> wsum;                     // The sum of the tables in sats -- the table of the window
+    vector <int> csum;                     // The sum of the tables in csats
+};
+
+class Bits_Engine : public DBSCAN_Engine {
+  public:
+    Bits_Engine(int R, int C, int e, int et, int mp);
+    void Push(const BitGrid &frame, char *labels);
+  protected:
+    int R, C, e, et, mp;
+    int N;
+    vector <BitCount> counts;              // Box counts of the last e_t+1 frames (a ring)
+    vector <BitGrid> dilated;              // Box-dilated cores of the last e_t+1 frames (a ring)
+    BitCount total;                        // Sum of the box counts in the ring
+    BitGrid core, border;
+    BitScratch scratch;                    // The kernels' temporaries, so they don't allocate
+};
+
+class Sparse_Engine : public DBSCAN_Engine {
+  public:
+    Sparse_Engine(int R, int C, int e, int et, int mp);
+    void Push(const BitGrid &frame, char *labels);
+  protected:
+    int Box(const vector <int> &starts, const vector <int> &cols, int j, int k, int most) const;
+    int R, C, e, et, mp;
+    int N;
+    vector < vector <int> > starts;        // Row j's events are cols[starts[j]..starts[j+1]-1] (a ring)
+    vector < vector <int> > cols;          // The columns of each frame's events, sorted by row and col
+    vector < vector <int> > cstarts;       // The same for the cores (a ring)
+    vector < vector <int> > ccols;
+};
+
+/* ------------------------------------------------------------ */
+/* LOOP */
+
+Loop_Engine::Loop_Engine(int r, int c, int eps, int eps_t, int minpts)
+{
+  R = r;
+  C = c;
+  e = eps;
+  et = eps_t;
+  mp = minpts;
+  N = 0;
+  events.resize(et+1);
+  ceb.resize(et+1);
+}
+
+void Loop_Engine::Push(const BitGrid &frame, char *labels)
+{
+  int i, j, k, ii, jj, kk, t, slot;
+
+  i = N;
+  slot = i % (et+1);
+  events[slot] = frame;
+  ceb[slot].assign((size_t) R * C, '.');
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (frame.Get(j, k)) {
+        t = 0;
+        for (ii = i-et; ii <= i; ii++) {
+          if (ii >= 0) {
+            for (jj = j-e; jj <= j+e; jj++) {
+              for (kk = k-e; kk <= k+e; kk++) {
+                if (jj >= 0 && jj < R && kk >= 0 && kk < C) {
+                  t += events[ii % (et+1)].Get(jj, kk);
+                }
+              }
+            }
+          }
+        }
+        if (t >= mp) ceb[slot][(size_t) j*C+k] = 'C';
+      }
+    }//k
+  }//j
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (frame.Get(j, k) && ceb[slot][(size_t) j*C+k] != 'C') {
+        for (ii = i-et; ii <= i; ii++) {
+          if (ii >= 0) {
+            for (jj = j-e; jj <= j+e; jj++) {
+              for (kk = k-e; kk <= k+e; kk++) {
+                if (jj >= 0 && jj < R && kk >= 0 && kk < C) {
+                  if (ceb[ii % (et+1)][(size_t) jj*C+kk] == 'C') ceb[slot][(size_t) j*C+k] = 'B';
+                }
+              }
+            }
+          }
+        }
+      }
+    }//k
+  }//j
+
+  copy(ceb[slot].begin(), ceb[slot].end(), labels);
+  N++;
+}
+
+/* ------------------------------------------------------------ */
+/* SAT */
+
+Sat_Engine::Sat_Engine(int r, int c, int eps, int eps_t, int minpts)
+{
+  R = r;
+  C = c;
+  e = eps;
+  et = eps_t;
+  mp = minpts;
+  N = 0;
+  sats.resize(et+1, vector <int> ((R+1)*(C+1), 0));
+  csats.resize(et+1, vector <int> ((R+1)*(C+1), 0));
+  wsum.resize((R+1)*(C+1), 0);
+  csum.resize((R+1)*(C+1), 0);
+}
+
+/* The box count of rows r0..r1 and columns c0..c1 is
+   sum[r1+1][c1+1] - sum[r0][c1+1] - sum[r1+1][c0] + sum[r0][c0]. */
+
+int Sat_Engine::Box(const vector <int> &sum, int j, int k) const
+{
+  int r0, r1, c0, c1;
+
+  r0 = (j-e < 0) ? 0 : j-e;
+  r1 = (j+e >= R) ? R-1 : j+e;
+  c0 = (k-e < 0) ? 0 : k-e;
+  c1 = (k+e >= C) ? C-1 : k+e;
+  return sum[(r1+1)*(C+1)+c1+1] - sum[r0*(C+1)+c1+1] - sum[(r1+1)*(C+1)+c0] + sum[r0*(C+1)+c0];
+}
+
+/* Build the table of the events (if frame isn't NULL) or of the cores in labels. */
+
+void Sat_Engine::Build(vector <int> &sat, const BitGrid *frame, const char *labels)
+{
+  int j, k, t;
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (frame != NULL) {
+        t = frame->Get(j, k);
+      } else {
+        t = (labels[(size_t) j*C+k] == 'C') ? 1 : 0;
+      }
+      sat[(j+1)*(C+1)+k+1] = t + sat[j*(C+1)+k+1] + sat[(j+1)*(C+1)+k] - sat[j*(C+1)+k];
+    }
+  }
+}
+
+/* Frame i's tables go into slot i%(e_t+1) of the rings, after subtracting the tables
+   of frame i-e_t-1 from the running sums. */
+
+void Sat_Engine::Push(const BitGrid &frame, char *labels)
+{
+  int j, k, slot, W;
+
+  W = (R+1)*(C+1);
+  slot = N % (et+1);
+  if (N > et) {
+    for (j = 0; j < W; j++) wsum[j] -= sats[slot][j];
+    for (j = 0; j < W; j++) csum[j] -= csats[slot][j];
+  }
+
+  Build(sats[slot], &frame, NULL);
+  for (j = 0; j < W; j++) wsum[j] += sats[slot][j];
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      labels[(size_t) j*C+k] = (frame.Get(j, k) && Box(wsum, j, k) >= mp) ? 'C' : '.';
+    }
+  }
+
+  Build(csats[slot], NULL, labels);
+  for (j = 0; j < W; j++) csum[j] += csats[slot][j];
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (frame.Get(j, k) && labels[(size_t) j*C+k] != 'C' && Box(csum, j, k) > 0) {
+        labels[(size_t) j*C+k] = 'B';
+      }
+    }
+  }
+  N++;
+}
+
+/* ------------------------------------------------------------ */
+/* BITS */
+
+Bits_Engine::Bits_Engine(int r, int c, int eps, int eps_t, int minpts)
+{
+  int slot, P;
+
+  R = r;
+  C = c;
+  e = eps;
+  et = eps_t;
+  mp = minpts;
+  N = 0;
+
+  P = Bit_Planes_For((2*e+1)*(2*e+1)*(et+1));
+  counts.resize(et+1);
+  dilated.resize(et+1);
+  for (slot = 0; slot <= et; slot++) {
+    counts[slot].Resize(R, C, P);
+    dilated[slot].Resize(R, C);
+  }
+  total.Resize(R, C, P);
+}
+
+/* Frame i's box counts go into slot i%(e_t+1) of the ring, after subtracting the
+   counts of frame i-e_t-1 from the total.  The cores are the events whose total
+   is at least mp.  The borders are the rest of the events that are in the
+   box-dilation of the cores of any frame in the window. */
+
+void Bits_Engine::Push(const BitGrid &frame, char *labels)
+{
+  int j, k, slot;
+  size_t w;
+
+  slot = N % (et+1);
+  if (N > et) Subtract_Counts(total, counts[slot], scratch);
+  Box_Count(frame, e, counts[slot], scratch);
+  Add_Counts(total, counts[slot], scratch);
+
+  At_Least(total, mp, core, scratch);
+  for (w = 0; w < core.Bits.size(); w++) core.Bits[w] &= frame.Bits[w];
+  Box_Dilate(core, e, dilated[slot], scratch);
+
+  border = dilated[slot];
+  for (j = 0; j <= et; j++) {
+    if (j != slot) for (w = 0; w < border.Bits.size(); w++) border.Bits[w] |= dilated[j].Bits[w];
+  }
+  for (w = 0; w < border.Bits.size(); w++) border.Bits[w] &= (frame.Bits[w] & ~core.Bits[w]);
+
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) {
+      if (core.Get(j, k)) {
+        labels[(size_t) j*C+k] = 'C';
+      } else if (border.Get(j, k)) {
+        labels[(size_t) j*C+k] = 'B';
+      } else {
+        labels[(size_t) j*C+k] = '.';
+      }
+    }
+  }
+  N++;
+}
+
+/* ------------------------------------------------------------ */
+/* SPARSE */
+
+Sparse_Engine::Sparse_Engine(int r, int c, int eps, int eps_t, int minpts)
+{
+  R = r;
+  C = c;
+  e = eps;
+  et = eps_t;
+  mp = minpts;
+  N = 0;
+  starts.resize(et+1, vector <int> (R+1, 0));
+  cols.resize(et+1);
+  cstarts.resize(et+1, vector <int> (R+1, 0));
+  ccols.resize(et+1);
+}
+
+/* Return the number of events in the box around row j, col k, but stop counting at most.
+   Each row of the box is two binary searches into the row's sorted columns. */
+
+int Sparse_Engine::Box(const vector <int> &st, const vector <int> &cl, int j, int k, int most) const
+{
+  int jj, r0, r1, t;
+  vector <int>::const_iterator b, en;
+
+  r0 = (j-e < 0) ? 0 : j-e;
+  r1 = (j+e >= R) ? R-1 : j+e;
+  t = 0;
+  for (jj = r0; jj <= r1 && t < most; jj++) {
+    if (st[jj] == st[jj+1]) continue;
+    b = lower_bound(cl.begin() + st[jj], cl.begin() + st[jj+1], k-e);
+    en = upper_bound(b, cl.begin() + st[jj+1], k+e);
+    t += en - b;
+  }
+  return t;
+}
+
+/* Frame i's events are pulled out of the bits a word at a time, into slot i%(e_t+1)
+   of the rings.  Then only the events, and the events in their windows, are visited. */
+
+void Sparse_Engine::Push(const BitGrid &frame, char *labels)
+{
+  int i, j, k, ii, t, slot, x;
+  uint64_t w;
+
+  i = N;
+  slot = i % (et+1);
+  cols[slot].clear();
+  for (j = 0; j < R; j++) {
+    starts[slot][j] = cols[slot].size();
+    for (x = 0; x < frame.Words; x++) {
+      for (w = frame.Row(j)[x]; w != 0; w &= w-1) cols[slot].push_back(x*64 + __builtin_ctzll(w));
+    }
+  }
+  starts[slot][R] = cols[slot].size();
+
+  fill(labels, labels + (size_t) R * C, '.');
+  ccols[slot].clear();
+  for (j = 0; j < R; j++) {
+    cstarts[slot][j] = ccols[slot].size();
+    for (x = starts[slot][j]; x < starts[slot][j+1]; x++) {
+      k = cols[slot][x];
+      t = 0;
+      for (ii = (i-et < 0) ? 0 : i-et; ii <= i && t < mp; ii++) {
+        t += Box(starts[ii % (et+1)], cols[ii % (et+1)], j, k, mp-t);
+      }
+      if (t >= mp) {
+        labels[(size_t) j*C+k] = 'C';
+        ccols[slot].push_back(k);
+      }
+    }
+  }
+  cstarts[slot][R] = ccols[slot].size();
+
+  for (j = 0; j < R; j++) {
+    for (x = starts[slot][j]; x < starts[slot][j+1]; x++) {
+      k = cols[slot][x];
+      if (labels[(size_t) j*C+k] == 'C') continue;
+      for (ii = (i-et < 0) ? 0 : i-et; ii <= i; ii++) {
+        if (Box(cstarts[ii % (et+1)], ccols[ii % (et+1)], j, k, 1) > 0) {
+          labels[(size_t) j*C+k] = 'B';
+          break;
+        }
+      }
+    }
+  }
+  N++;
+}
+
+/* ------------------------------------------------------------ */
+/* The interface */
+
+/* AUTO: SPARSE does about (e_t+1)(2e+1) binary searches per event, while BITS does about
+   (e_t+2)(2e+1) word operations per 64 cells.  On random frames, SPARSE wins when
+   fill * (e_t+1) is below about 0.02, which is typical of event-camera frames. */
+
+string DBSCAN_Auto_Engine(long long on, long long cells, int epsilon_t)
+{
+  if (cells == 0) return "BITS";
+  return ((double) on / cells * (epsilon_t+1) < 0.02) ? "SPARSE" : "BITS";
+}
+
+DBSCAN::DBSCAN(int rows, int cols, int epsilon, int epsilon_t, int minpoints, const string &engine)
+{
+  if (rows < 0 || cols < 0) throw runtime_error("DBSCAN: rows and cols must be >= 0");
+  if (epsilon < 0) throw runtime_error("DBSCAN: epsilon must be >= 0");
+  if (epsilon_t < 0) throw runtime_error("DBSCAN: epsilon_t must be >= 0");
+  if (engine != "LOOP" && engine != "SAT" && engine != "BITS" &&
+      engine != "SPARSE" && engine != "AUTO") {
+    throw runtime_error("DBSCAN: engine must be LOOP, SAT, BITS, SPARSE or AUTO");
+  }
+  R = rows;
+  C = cols;
+  E = epsilon;
+  Et = epsilon_t;
+  Mp = minpoints;
+  N = 0;
+  Name = engine;
+  Engine = NULL;
+  Auto = (engine == "AUTO");
+  Auto_On = 0;
+  Auto_Frames = 0;
+  if (Auto) History.resize(2 * Et);
+}
+
+DBSCAN::~DBSCAN()
+{
+  if (Engine != NULL) delete Engine;
+}
+
+void DBSCAN::Push(const unsigned char *frame, char *labels)
+{
+  int j, k;
+
+  if (Packed.Rows != R || Packed.Cols != C) {
+    Packed.Resize(R, C);
+  } else {
+    Packed.Clear();
+  }
+  for (j = 0; j < R; j++) {
+    for (k = 0; k < C; k++) if (frame[(size_t) j*C+k]) Packed.Set(j, k);
+  }
+  Push(Packed, labels);
+}
+
+DBSCAN_Engine *DBSCAN::New_Engine(const string &name) const
+{
+  if (name == "LOOP") return new Loop_Engine(R, C, E, Et, Mp);
+  if (name == "SAT") return new Sat_Engine(R, C, E, Et, Mp);
+  if (name == "BITS") return new Bits_Engine(R, C, E, Et, Mp);
+  return new Sparse_Engine(R, C, E, Et, Mp);
+}
+
+/* The next frame's labels depend on the cores of the last e_t frames, and those depend on the
+   e_t frames before them, so the new engine gets the last 2e_t frames, oldest first.  Their
+   labels are thrown away. */
+
+void DBSCAN::Switch_Engine(const string &name)
+{
+  int i, n;
+
+  delete Engine;
+  Name = name;
+  Engine = New_Engine(Name);
+  n = min(N, 2 * Et);
+  if (n > 0) Scratch.resize((size_t) R * C);
+  for (i = N - n; i < N; i++) Engine->Push(History[i % History.size()], Scratch.data());
+}
+
+/* AUTO measures the fill of the first frame, and then of every DBSCAN_AUTO_FRAMES frames,
+   and switches engines if the measurement picks the other one. */
+
+void DBSCAN::Push(const BitGrid &frame, char *labels)
+{
+  long long on;
+  string name;
+
+  if (frame.Rows != R || frame.Cols != C) throw runtime_error("DBSCAN: frame is the wrong size");
+
+  if (Auto) {
+    on = frame.Count();
+    if (Engine == NULL) {
+      Name = DBSCAN_Auto_Engine(on, (long long) R * C, Et);
+    } else if (Auto_Frames == DBSCAN_AUTO_FRAMES) {
+      name = DBSCAN_Auto_Engine(Auto_On, (long long) R * C * Auto_Frames, Et);
+      if (name != Name) Switch_Engine(name);
+      Auto_On = 0;
+      Auto_Frames = 0;
+    }
+    Auto_On += on;
+    Auto_Frames++;
+  }
+  if (Engine == NULL) Engine = New_Engine(Name);
+  Engine->Push(frame, labels);
+  if (Auto && History.size() > 0) History[N % History.size()] = frame;
+  N++;
+}
+
+int DBSCAN::Rows() const { return R; }
+int DBSCAN::Cols() const { return C; }
+int DBSCAN::Frames() const { return N; }
+string DBSCAN::Engine_Name() const { return Name; }
+
+void DBSCAN_2D(const unsigned char *grid, int rows, int cols, int epsilon, int minpoints,
+               char *labels, const string &engine)
+{
+  DBSCAN d(rows, cols, epsilon, 0, minpoints, engine);
+
+  d.Push(grid, labels);
+}
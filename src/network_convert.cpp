@@ -0,0 +1,79 @@
+/* This program converts a network to JSON or to the binary format in include/snn_network.hpp.
+   The input can be any of:
+
+   - The network_tool commands that the dbscan_xxx and 3d_dbscan_xxx programs print.
+   - A JSON network, from network_tool or from those programs with JSON.
+   - A binary network, from those programs with BINARY, or from this program.
+
+   It figures out which one from the first bytes of the input.  The input file can be "-"
+   for standard input.  So, for example, this converts a binary network back to JSON, for
+   the processor_tool:
+
+     bin/network_convert tmp-dbscan-network.bin JSON > tmp-dbscan-network.txt
+ */
+
+/* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include "snn_network.hpp"
+#include "network_builder.hpp"
+using namespace std;
+
+int main(int argc, char **argv)
+{
+  string fn, format, text;
+  FILE *f;
+  char block[65536];
+  size_t n, i;
+  SNN_Network binary;
+  Network_Builder net;
+
+  if (argc != 3 || (string(argv[2]) != "JSON" && string(argv[2]) != "BINARY")) {
+    fprintf(stderr, "usage: bin/network_convert input-network|- JSON|BINARY\n");
+    exit(1);
+  }
+  fn = argv[1];
+  format = argv[2];
+
+  /* Binary files are mapped rather than read. */
+
+  if (fn != "-") {
+    f = fopen(fn.c_str(), "r");
+    if (f == NULL) { perror(fn.c_str()); exit(1); }
+    n = fread(block, 1, 8, f);
+    fclose(f);
+    if (SNN_Is_Binary(block, n)) {
+      binary.Load(fn);
+      net.Read_Binary(binary, format);
+      net.Finish();
+      return 0;
+    }
+  }
+
+  f = (fn == "-") ? stdin : fopen(fn.c_str(), "r");
+  if (f == NULL) { perror(fn.c_str()); exit(1); }
+  while ((n = fread(block, 1, sizeof(block), f)) > 0) text.append(block, n);
+  if (f != stdin) fclose(f);
+
+  if (text.size() == 0) { fprintf(stderr, "%s is empty\n", fn.c_str()); exit(1); }
+
+  if (SNN_Is_Binary(text.data(), text.size())) {
+    binary.From_Memory(text.data(), text.size(), "standard input");
+    net.Read_Binary(binary, format);
+  } else {
+    for (i = 0; i < text.size() && isspace(text[i]); i++) ;
+    if (i < text.size() && text[i] == '{') {
+      net.Read_JSON(text, format);
+    } else {
+      net.Read_Commands(text, format);
+    }
+  }
+  net.Finish();
+  return 0;
+}
@@ -14,42 +14,23 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include "dbscan_outputs.hpp"
 using namespace std;
 
 int main()
 {
   string line;
-  int n, r, c, s;
-  map < int, map < int, string > > pts;
-  map < int, map < int, string > >::iterator pit;
-  map < int, string >::iterator iit;
-  string cell;
+  vector <DBSCAN_Output> outs;
+  DBSCAN_Output o;
 
   while (getline(cin, line)) {
-
-    if (sscanf(line.c_str(), "node %d(Border[%d][%d]) spike counts: %d", 
-        &n, &r, &c, &s) == 4) {
-      cell = "B";
-    } else if (sscanf(line.c_str(), "node %d(Core[%d][%d]) spike counts: %d", 
-        &n, &r, &c, &s) == 4) {
-      cell = "C";
+    if (DBSCAN_Read_Output(line, o)) {
+      outs.push_back(o);
     } else {
       printf("Unknown line: %s\n", line.c_str());
     }
-
-    if (pts[r][c] == "") {
-      pts[r][c] = (s == 0) ? "." : cell;
-    } else if (s != 0) {
-      pts[r][c] = cell;
-    }
   }
 
-  for (pit = pts.begin(); pit != pts.end(); pit++) {
-    for (iit = pit->second.begin(); iit != pit->second.end(); iit++) {
-      printf("%s", iit->second.c_str());
-    }
-    printf("\n");
-  }
+  DBSCAN_Output_Flat(outs);
   return 0;
-  
 }
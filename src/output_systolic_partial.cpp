@@ -14,18 +14,15 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include "dbscan_outputs.hpp"
 using namespace std;
 
 int main(int argc, char **argv)
 {
-  string line, w;
-  double d;
-  int n, r, c, cols, e, sc, i;
-  map < int, string > pts;
-  map < int, string >::iterator pit;
-  vector <string> sv;
-  istringstream ss;
-  string cell;
+  string line;
+  int e, cols;
+  vector <DBSCAN_Output> outs;
+  DBSCAN_Output o;
 
   if (argc != 3) {
     fprintf(stderr, "usage: bin/output_systolic_partial e I_C\n");
@@ -36,32 +33,13 @@ int main(int argc, char **argv)
   cols = atoi(argv[2]);
 
   while (getline(cin, line)) {
-    ss.clear();
-    sv.clear();
-    ss.str(line);
-    while (ss >> w) sv.push_back(w);
-
-    if (sscanf(line.c_str(), "node %d(Border[%d][%d]) spike times:", &n, &r, &c) == 3) {
-      cell = "B";
-      sc = e*4 + 4;
-    } else if (sscanf(line.c_str(), "node %d(Core[%d][%d]) spike times:", &n, &r, &c) == 3) {
-      cell = "C";
-      sc = e*3 + 2;
-      pts[r].resize(cols, '.');
+    if (DBSCAN_Read_Output(line, o)) {
+      outs.push_back(o);
     } else {
       printf("Unknown line: %s\n", line.c_str());
     }
-
-    for (i = 4; i < (int) sv.size(); i++) {
-      sscanf(sv[i].c_str(), "%lf", &d);
-      c = d - sc;
-      if (c >= 0 && c < cols) pts[r][c] = cell[0];
-    }
   }
 
-  for (pit = pts.begin(); pit != pts.end(); pit++) {
-    printf("%s\n", pit->second.c_str());
-  }
+  DBSCAN_Output_Systolic_Partial(outs, e, cols);
   return 0;
-  
 }
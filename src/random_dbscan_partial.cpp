@@ -57,14 +57,18 @@ int main()
   printf("echo e=%d minPts=%d I_R=%d I_C=%d\n", e, mp, ir, ic);
   printf("sh scripts/process_dbscan_partial.sh %d %d tmp-data.txt %d %d %d %d FLAT $fr > %s\n", 
             e, mp, ir, ic, sr, sc, "tmp-o1.txt");
-  printf("( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'\n");
+  printf("if [ \"$fr\" != - ]; then ( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'; fi\n");
   printf("sh scripts/process_dbscan_partial.sh %d %d tmp-data.txt %d %d %d %d SYSTOLIC $fr > %s\n", 
             e, mp, ir, ic, sr, sc, "tmp-o2.txt");
-  printf("( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'\n");
+  printf("if [ \"$fr\" != - ]; then ( echo FJ tmp-dbscan-network.txt; echo INFO ) | $fr/bin/network_tool | egrep 'No|Ed'; fi\n");
   printf("bin/dbscan %d %d tmp-data.txt %d %d %d %d > tmp-o3.txt\n", e, mp, ir, ic, sr, sc);
+  printf("bin/dbscan %d %d tmp-data.txt %d %d %d %d SAT > tmp-o4.txt\n", e, mp, ir, ic, sr, sc);
+  printf("bin/dbscan %d %d tmp-data.txt %d %d %d %d BITS > tmp-o5.txt\n", e, mp, ir, ic, sr, sc);
   printf("d1=`diff tmp-o1.txt tmp-o2.txt | wc | awk '{ print $1 }'`\n");
   printf("d2=`diff tmp-o1.txt tmp-o3.txt | wc | awk '{ print $1 }'`\n");
-  printf("if [ $d1 = 0 -a $d2 = 0 ]; then echo ok; else echo no; fi\n");
+  printf("d3=`diff tmp-o1.txt tmp-o4.txt | wc | awk '{ print $1 }'`\n");
+  printf("d4=`diff tmp-o1.txt tmp-o5.txt | wc | awk '{ print $1 }'`\n");
+  printf("if [ $d1 = 0 -a $d2 = 0 -a $d3 = 0 -a $d4 = 0 ]; then echo ok; else echo no; fi\n");
 
   return 0;
 }
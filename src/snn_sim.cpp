@@ -0,0 +1,271 @@
+/* This program runs the networks that the dbscan_xxx and 3d_dbscan_xxx programs make, with
+   the simulator in include/snn_simulator.hpp, instead of the framework's processor_tool.
+   It reads the same commands as the processor_tool on standard input, and prints the same
+   output, so the scripts can use either one.  It only knows the commands that this
+   repository uses:
+
+     M risp params            Set the RISP parameters -- the JSON can span lines.
+     EMPTYNET file            Write an empty network with those parameters to file.
+     ML file                  Load a network: binary, JSON, or network_tool commands.
+     AS node time val         Apply a spike to an input neuron.
+     ASR node raster          Apply a spike at every time t where raster[t] is '1'.
+     AST node time ...        Apply a spike at each time -- the compact form of ASR, which
+                              create_spikes_xxx prints in the _AST modes.
+     RUN time                 Run the network.
+     OC / OT                  Print the output neurons' spike counts / spike times.
+     OE                       Print the last run's output spikes one per line, in time order,
+                              as "node n(name) spike times: t", then "time t" -- see below.
+     CA                       Clear the activity in the network.
+     Q                        Quit.
+
+   Blank lines and lines that start with '#' are ignored.
+
+   OE is for decoding while the network runs: you alternate RUN and OE, and pipe the output
+   into a decoder, like bin/3d_output_flat_partial_stream with EVENTS.  Its times are from
+   the ML or the last CA rather than from the start of the last run, so they keep going up
+   from one OE to the next, and the "time t" line at the end says that all of the spikes
+   before time t have been printed.  The output is flushed after each OE.
+
+   The engine on the command line is EVENT (include/snn_simulator.hpp), LAYER
+   (include/layer_simulator.hpp), or AUTO, which is the default.  AUTO uses LAYER when the
+   network is layered, like the flat networks, and EVENT otherwise.  LAYER fails if the
+   network isn't layered.
+ */
+
+/* Charles P. Rizzo, James S. Plank, University of Tennessee, 2025 */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include "snn_network.hpp"
+#include "network_builder.hpp"
+#include "snn_simulator.hpp"
+#include "layer_simulator.hpp"
+using namespace std;
+
+/* Read a whole file, or fail. */
+
+string Read_File(const string &fn)
+{
+  FILE *f;
+  char block[65536];
+  size_t n;
+  string text;
+
+  f = fopen(fn.c_str(), "r");
+  if (f == NULL) { perror(fn.c_str()); exit(1); }
+  while ((n = fread(block, 1, sizeof(block), f)) > 0) text.append(block, n);
+  fclose(f);
+  return text;
+}
+
+int main(int argc, char **argv)
+{
+  string line, cmd, fn, params, s, bin, engine, why;
+  istringstream ss;
+  map <int, int> input_index;
+  SNN_Network *net;
+  SNN_Simulator *sim;
+  Layer_Simulator *layers;
+  Network_Builder *nb;
+  int ln, depth, id, t, i, j;
+  int elapsed, run_start;                /* For OE, since the ML or the last CA */
+  vector < pair <int, int> > events;     /* For OE: (time, output) */
+  double v;
+  size_t k;
+  FILE *f;
+
+  engine = (argc > 1) ? argv[1] : "AUTO";
+  if (argc > 2 || (engine != "EVENT" && engine != "LAYER" && engine != "AUTO")) {
+    fprintf(stderr, "usage: bin/snn_sim [EVENT|LAYER|AUTO] < commands\n");
+    exit(1);
+  }
+
+  net = NULL;
+  sim = NULL;
+  ln = 0;
+  elapsed = 0;
+  run_start = 0;
+
+  while (getline(cin, line)) {
+    ln++;
+    ss.clear();
+    ss.str(line);
+    if (!(ss >> cmd) || cmd[0] == '#') continue;
+
+    /* The parameters follow "M risp", and may span lines, so read until the braces
+       balance. */
+
+    if (cmd == "M") {
+      if (!(ss >> s) || s != "risp") {
+        fprintf(stderr, "Line %d: only \"M risp\" is supported\n", ln);
+        exit(1);
+      }
+      getline(ss, params);
+      while (true) {
+        depth = 0;
+        for (k = 0; k < params.size(); k++) {
+          if (params[k] == '{') depth++;
+          if (params[k] == '}') depth--;
+        }
+        if (depth == 0 && params.find('{') != string::npos) break;
+        if (!getline(cin, line)) {
+          fprintf(stderr, "Line %d: the RISP parameters end early\n", ln);
+          exit(1);
+        }
+        ln++;
+        params += "\n" + line;
+      }
+
+    } else if (cmd == "EMPTYNET") {
+      if (params == "") { fprintf(stderr, "Line %d: EMPTYNET needs M first\n", ln); exit(1); }
+      if (!(ss >> fn)) { fprintf(stderr, "Line %d: usage: EMPTYNET file\n", ln); exit(1); }
+      s = SNN_Empty_Network(params);
+      f = fopen(fn.c_str(), "w");
+      if (f == NULL) { perror(fn.c_str()); exit(1); }
+      fwrite(s.data(), 1, s.size(), f);
+      fclose(f);
+
+    /* Binary networks are mapped.  Anything else is converted to binary in memory. */
+
+    } else if (cmd == "ML") {
+      if (!(ss >> fn)) { fprintf(stderr, "Line %d: usage: ML file\n", ln); exit(1); }
+      if (net != NULL) delete net;
+      net = new SNN_Network;
+      s = Read_File(fn);
+      if (SNN_Is_Binary(s.data(), s.size())) {
+        s.clear();
+        net->Load(fn);
+      } else {
+        for (k = 0; k < s.size() && isspace(s[k]); k++) ;
+        bin.clear();
+        nb = new Network_Builder;
+        nb->Write_To(&bin);
+        if (k < s.size() && s[k] == '{') {
+          nb->Read_JSON(s, "BINARY");
+        } else {
+          nb->Read_Commands(s, "BINARY");
+        }
+        nb->Finish();
+        delete nb;
+        s.clear();
+        net->From_Memory(bin.data(), bin.size(), fn);
+      }
+      if (sim != NULL) delete sim;
+      sim = NULL;
+      if (engine == "LAYER") {
+        layers = new Layer_Simulator;
+        layers->Load(*net);
+        sim = layers;
+      } else if (engine == "AUTO") {
+        layers = new Layer_Simulator;
+        if (layers->Try_Load(*net, why)) {
+          sim = layers;
+        } else {
+          delete layers;
+        }
+      }
+      if (sim == NULL) {
+        sim = new SNN_Simulator;
+        sim->Load(*net);
+      }
+      input_index.clear();
+      elapsed = 0;
+      run_start = 0;
+      for (i = 0; i < (int) net->Num_Inputs; i++) input_index[net->Inputs[i]] = i;
+
+    } else if (sim == NULL && cmd != "Q") {
+      fprintf(stderr, "Line %d: %s needs a network (ML) first\n", ln, cmd.c_str());
+      exit(1);
+
+    } else if (cmd == "AS") {
+      if (!(ss >> id >> t >> v)) { fprintf(stderr, "Line %d: usage: AS node time val\n", ln); exit(1); }
+      if (input_index.find(id) == input_index.end()) {
+        fprintf(stderr, "Line %d: node %d isn't an input\n", ln, id);
+        exit(1);
+      }
+      sim->Apply_Spike(input_index[id], t, v);
+
+    } else if (cmd == "ASR") {
+      if (!(ss >> id >> s)) { fprintf(stderr, "Line %d: usage: ASR node raster\n", ln); exit(1); }
+      if (input_index.find(id) == input_index.end()) {
+        fprintf(stderr, "Line %d: node %d isn't an input\n", ln, id);
+        exit(1);
+      }
+      for (t = 0; t < (int) s.size(); t++) {
+        if (s[t] == '1') sim->Apply_Spike(input_index[id], t, 1);
+      }
+
+    } else if (cmd == "AST") {
+      if (!(ss >> id)) { fprintf(stderr, "Line %d: usage: AST node time ...\n", ln); exit(1); }
+      if (input_index.find(id) == input_index.end()) {
+        fprintf(stderr, "Line %d: node %d isn't an input\n", ln, id);
+        exit(1);
+      }
+      while (ss >> t) {
+        if (t < 0) { fprintf(stderr, "Line %d: negative time %d\n", ln, t); exit(1); }
+        sim->Apply_Spike(input_index[id], t, 1);
+      }
+      if (!ss.eof()) { fprintf(stderr, "Line %d: usage: AST node time ...\n", ln); exit(1); }
+
+    } else if (cmd == "RUN") {
+      if (!(ss >> t) || t < 0) { fprintf(stderr, "Line %d: usage: RUN time\n", ln); exit(1); }
+      sim->Run(t);
+      run_start = elapsed;
+      elapsed += t + ((sim->Run_Time_Inclusive) ? 1 : 0);
+
+    } else if (cmd == "OC" || cmd == "OT") {
+      for (i = 0; i < sim->Num_Outputs(); i++) {
+        id = sim->Output_Node(i);
+        printf("node %d", id);
+        if (net->Name(id)[0] != '\0') printf("(%s)", net->Name(id));
+        if (cmd == "OC") {
+          printf(" spike counts: %d\n", (int) sim->Output_Times(i).size());
+        } else {
+          printf(" spike times:");
+          for (j = 0; j < (int) sim->Output_Times(i).size(); j++) printf(" %.1f", (double) sim->Output_Times(i)[j]);
+          printf("\n");
+        }
+      }
+
+    } else if (cmd == "OE") {
+      events.clear();
+      for (i = 0; i < sim->Num_Outputs(); i++) {
+        for (j = 0; j < (int) sim->Output_Times(i).size(); j++) {
+          events.push_back(make_pair(sim->Output_Times(i)[j], i));
+        }
+      }
+      sort(events.begin(), events.end());
+      for (k = 0; k < events.size(); k++) {
+        id = sim->Output_Node(events[k].second);
+        printf("node %d", id);
+        if (net->Name(id)[0] != '\0') printf("(%s)", net->Name(id));
+        printf(" spike times: %.1f\n", (double) (run_start + events[k].first));
+      }
+      printf("time %d\n", elapsed);
+      fflush(stdout);
+
+    } else if (cmd == "CA") {
+      sim->Clear_Activity();
+      elapsed = 0;
+      run_start = 0;
+
+    } else if (cmd == "Q") {
+      break;
+
+    } else {
+      fprintf(stderr, "Line %d: unknown command %s\n", ln, cmd.c_str());
+      exit(1);
+    }
+  }
+
+  if (sim != NULL) delete sim;
+  if (net != NULL) delete net;
+  return 0;
+}